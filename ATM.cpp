@@ -3,6 +3,28 @@
 #include <vector>
 #include <map>
 #include <stdexcept>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <condition_variable>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
 
 // Use standard namespace for simplicity as requested
 using namespace std;
@@ -25,34 +47,640 @@ public:
     }
 };
 
-// Represents a user's bank account
+// Money is held in integer cents so balances never pick up rounding error
+string formatMoney(int64_t cents) {
+    char text[32];
+    snprintf(text, sizeof(text), "%s$%lld.%02lld", cents < 0 ? "-" : "", static_cast<long long>(llabs(cents) / 100),
+             static_cast<long long>(llabs(cents) % 100));
+    return text;
+}
+
+int64_t toCents(double amount) {
+    return llround(amount * 100);
+}
+
+// Represents a user's bank account. Every balance change happens under the
+// account's own lock, so concurrent sessions on one account cannot overdraw it.
 class BankAccount {
 private:
     string accountNumber;
-    double balance;
+    int64_t balance; // cents
+    mutable mutex lock;
 
 public:
-    BankAccount(const string& accNum, double initialBalance) : accountNumber(accNum), balance(initialBalance) {}
+    BankAccount(const string& accNum, int64_t initialCents) : accountNumber(accNum), balance(initialCents) {}
+
+    string getAccountNumber() const {
+        return accountNumber;
+    }
+
+    int64_t getBalance() const {
+        lock_guard<mutex> guard(lock);
+        return balance;
+    }
+
+    // `onApplied` runs under the lock after the change, so a journal records
+    // changes to one account in the order they happened
+    bool deposit(int64_t cents, const function<void()>& onApplied = nullptr) {
+        if (cents <= 0) return false;
+        lock_guard<mutex> guard(lock);
+        balance += cents;
+        if (onApplied) onApplied();
+        return true;
+    }
+
+    bool withdraw(int64_t cents, const function<void()>& onApplied = nullptr) {
+        if (cents <= 0) return false;
+        lock_guard<mutex> guard(lock);
+        if (balance < cents) return false;
+        balance -= cents;
+        if (onApplied) onApplied();
+        return true;
+    }
+
+    // Recovery only: sets the balance rebuilt from a snapshot and the journal
+    void restoreBalance(int64_t cents) {
+        lock_guard<mutex> guard(lock);
+        balance = cents;
+    }
+
+    // Global lock order: account number, then address for accounts that share a number
+    // (the Bank rejects duplicates, but standalone accounts are not registered anywhere)
+    static bool locksBefore(const BankAccount* a, const BankAccount* b) {
+        if (a->accountNumber != b->accountNumber) return a->accountNumber < b->accountNumber;
+        return less<const BankAccount*>()(a, b);
+    }
+
+    // Both accounts are locked in the global order, so two opposite
+    // transfers can never hold one lock each and wait forever
+    static bool transfer(BankAccount& from, BankAccount& to, int64_t cents, const function<void()>& onApplied = nullptr) {
+        if (cents <= 0 || &from == &to) return false;
+        bool fromFirst = locksBefore(&from, &to);
+        lock_guard<mutex> first(fromFirst ? from.lock : to.lock);
+        lock_guard<mutex> second(fromFirst ? to.lock : from.lock);
+        if (from.balance < cents) return false;
+        from.balance -= cents;
+        to.balance += cents;
+        if (onApplied) onApplied();
+        return true;
+    }
+
+    // Locks every account in the global order, for a consistent checkpoint
+    static vector<unique_lock<mutex>> lockAll(vector<BankAccount*> accounts) {
+        sort(accounts.begin(), accounts.end(), locksBefore);
+        vector<unique_lock<mutex>> guards;
+        for (BankAccount* account : accounts) guards.emplace_back(account->lock);
+        return guards;
+    }
 
-    double getBalance() const {
+    // Caller holds the lock from lockAll()
+    int64_t balanceWhileLocked() const {
         return balance;
     }
+};
+
+// --- Credential Store: salted PIN digests in an open-addressing table ---
+
+// SipHash-2-4: a keyed 64-bit hash, used both to key the table by card number and to
+// digest salted PINs. Neither card numbers nor PINs are stored.
+uint64_t sipHash24(uint64_t k0, uint64_t k1, const char* data, size_t length) {
+    auto rotl = [](uint64_t x, int b) { return (x << b) | (x >> (64 - b)); };
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0, v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0, v3 = 0x7465646279746573ULL ^ k1;
+    auto round = [&] {
+        v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+        v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+    };
+    size_t whole = length & ~size_t(7);
+    for (size_t i = 0; i < whole; i += 8) {
+        uint64_t m;
+        memcpy(&m, data + i, 8);
+        v3 ^= m;
+        round();
+        round();
+        v0 ^= m;
+    }
+    uint64_t last = static_cast<uint64_t>(length) << 56;
+    for (size_t i = whole; i < length; ++i) last |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * (i - whole));
+    v3 ^= last;
+    round();
+    round();
+    v0 ^= last;
+    v2 ^= 0xff;
+    for (int i = 0; i < 4; ++i) round();
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+// Examines every byte whatever the inputs, so timing does not reveal how much matched
+bool constantTimeEquals(const void* a, const void* b, size_t length) {
+    const volatile uint8_t* x = static_cast<const volatile uint8_t*>(a);
+    const volatile uint8_t* y = static_cast<const volatile uint8_t*>(b);
+    uint8_t difference = 0;
+    for (size_t i = 0; i < length; ++i) difference |= x[i] ^ y[i];
+    return difference == 0;
+}
+
+enum class AuthResult { OK, WRONG_PIN, LOCKED, UNKNOWN_CARD };
+
+// Linear probing over a power-of-two table kept at most half full, so a lookup
+// touches one or two adjacent 32-byte slots. Enrolment is single-threaded setup;
+// verify() is safe from many threads afterwards.
+class CredentialStore {
+private:
+    static const uint32_t MAX_FAILED_ATTEMPTS = 3;
+
+    // A card is identified by two independent keyed hashes, 95 bits in all, so two card
+    // numbers sharing a slot stays negligible even at hundreds of millions of cards
+    struct Slot {
+        uint64_t cardKey = 0; // keyed hash of the card number; 0 marks an empty slot
+        uint64_t salt = 0;
+        uint64_t pinDigest = 0;
+        uint32_t cardCheck = 0; // second hash of the card number, fills what was padding
+        atomic<uint32_t> failedAttempts{0};
+    };
+
+    struct CardId {
+        uint64_t key;
+        uint32_t check;
+    };
+
+    uint64_t tableKey0, tableKey1; // secret keys for card hashing
+    uint64_t checkKey0, checkKey1;
+    uint64_t pepper0, pepper1; // secret keys mixed into every PIN digest
+    unique_ptr<Slot[]> slots;
+    size_t capacity = 0;
+    size_t used = 0;
+    mt19937_64 saltSource;
+
+    CardId cardId(const string& cardNumber) const {
+        return { sipHash24(tableKey0, tableKey1, cardNumber.data(), cardNumber.size()) | 1, // never 0
+                 static_cast<uint32_t>(sipHash24(checkKey0, checkKey1, cardNumber.data(), cardNumber.size())) };
+    }
 
-    void deposit(double amount) {
-        if (amount > 0) {
-            balance += amount;
-            cout << "Deposit successful. New balance: $" << balance << endl;
+    uint64_t pinDigest(uint64_t salt, const string& pin) const {
+        return sipHash24(pepper0 ^ salt, pepper1, pin.data(), pin.size());
+    }
+
+    // Bit 0 of a key is always set, so the home slot comes from the bits above it
+    size_t home(uint64_t key) const {
+        return (key >> 1) & (capacity - 1);
+    }
+
+    static bool holds(const Slot& slot, CardId id) {
+        return slot.cardKey == id.key && slot.cardCheck == id.check;
+    }
+
+    Slot* find(CardId id) const {
+        for (size_t i = home(id.key);; i = (i + 1) & (capacity - 1)) {
+            if (holds(slots[i], id)) return &slots[i];
+            if (slots[i].cardKey == 0) return nullptr;
         }
     }
 
-    bool withdraw(double amount) {
-        if (amount > 0 && balance >= amount) {
-            balance -= amount;
-            cout << "Withdrawal successful. New balance: $" << balance << endl;
-            return true;
+    // A colliding cardKey with a different check is another card: keep probing
+    Slot& insertSlot(CardId id) {
+        size_t i = home(id.key);
+        while (slots[i].cardKey != 0 && !holds(slots[i], id)) i = (i + 1) & (capacity - 1);
+        if (slots[i].cardKey == 0) ++used;
+        slots[i].cardKey = id.key;
+        slots[i].cardCheck = id.check;
+        return slots[i];
+    }
+
+    void grow() {
+        unique_ptr<Slot[]> old = move(slots);
+        size_t oldCapacity = capacity;
+        capacity = max<size_t>(16, capacity * 2);
+        slots = make_unique<Slot[]>(capacity);
+        used = 0;
+        for (size_t i = 0; i < oldCapacity; ++i) {
+            if (old[i].cardKey == 0) continue;
+            Slot& slot = insertSlot({old[i].cardKey, old[i].cardCheck});
+            slot.salt = old[i].salt;
+            slot.pinDigest = old[i].pinDigest;
+            slot.failedAttempts.store(old[i].failedAttempts.load());
+        }
+    }
+
+public:
+    CredentialStore() {
+        random_device seed;
+        saltSource.seed((static_cast<uint64_t>(seed()) << 32) | seed());
+        tableKey0 = saltSource();
+        tableKey1 = saltSource();
+        pepper0 = saltSource();
+        pepper1 = saltSource();
+        checkKey0 = saltSource();
+        checkKey1 = saltSource();
+        grow();
+    }
+
+    void reserve(size_t cards) {
+        while (cards * 2 > capacity) grow();
+    }
+
+    void enroll(const string& cardNumber, const string& pin) {
+        if ((used + 1) * 2 > capacity) grow();
+        Slot& slot = insertSlot(cardId(cardNumber));
+        slot.salt = saltSource();
+        slot.pinDigest = pinDigest(slot.salt, pin);
+        slot.failedAttempts.store(0);
+    }
+
+    AuthResult verify(const string& cardNumber, const string& pin) const {
+        Slot* slot = find(cardId(cardNumber));
+        // Unknown cards still pay for a digest, so they take as long as known ones
+        uint64_t salt = slot ? slot->salt : 0;
+        uint64_t expected = slot ? slot->pinDigest : 0;
+        uint64_t actual = pinDigest(salt, pin);
+        if (slot == nullptr) return AuthResult::UNKNOWN_CARD;
+        // Reserve this attempt before comparing, so concurrent guesses from several
+        // terminals can never make more than MAX_FAILED_ATTEMPTS tries between them
+        uint32_t attempts = slot->failedAttempts.load(memory_order_relaxed);
+        do {
+            if (attempts >= MAX_FAILED_ATTEMPTS) return AuthResult::LOCKED;
+        } while (!slot->failedAttempts.compare_exchange_weak(attempts, attempts + 1, memory_order_relaxed));
+        if (constantTimeEquals(&expected, &actual, sizeof(actual))) {
+            slot->failedAttempts.store(0, memory_order_relaxed);
+            return AuthResult::OK;
+        }
+        return attempts + 1 >= MAX_FAILED_ATTEMPTS ? AuthResult::LOCKED : AuthResult::WRONG_PIN;
+    }
+
+    // Branch staff clear a lockout after checking the customer's identity
+    void unlock(const string& cardNumber) {
+        if (Slot* slot = find(cardId(cardNumber))) slot->failedAttempts.store(0);
+    }
+
+    // Longest probe sequence in the table: the worst case a lookup can hit
+    size_t longestProbe() const {
+        size_t longest = 0;
+        for (size_t i = 0; i < capacity; ++i) {
+            if (slots[i].cardKey == 0) continue;
+            longest = max(longest, ((i - home(slots[i].cardKey)) & (capacity - 1)) + 1);
+        }
+        return longest;
+    }
+
+    size_t size() const { return used; }
+    size_t bytes() const { return capacity * sizeof(Slot); }
+};
+
+// --- Write-Ahead Log: checksummed records with group commit ---
+
+uint32_t crc32(const void* data, size_t length) {
+    static const auto table = [] {
+        array<uint32_t, 256> entries{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entries[i] = c;
+        }
+        return entries;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; ++i) crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Makes a completed rename durable
+void syncParentDirectory(const string& path) {
+    size_t slash = path.find_last_of('/');
+    string directory = slash == string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int dirFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd < 0) throw runtime_error("Cannot open directory: " + directory);
+    bool synced = fsync(dirFd) == 0;
+    close(dirFd);
+    if (!synced) throw runtime_error("Cannot sync directory: " + directory);
+}
+
+enum class LogOp : uint8_t { DEPOSIT = 1, WITHDRAW, TRANSFER };
+
+// Fixed 56-byte record; the checksum covers every byte before it
+struct LogRecord {
+    uint64_t lsn;
+    int64_t amount; // cents
+    char account[16];
+    char target[16]; // transfers only
+    LogOp op;
+    uint8_t padding[3];
+    uint32_t checksum;
+
+    uint32_t computeChecksum() const {
+        return crc32(this, offsetof(LogRecord, checksum));
+    }
+};
+
+// Appends are cheap and ordered; a committer thread writes whatever is pending (up to
+// maxBatch records) with one write and one fdatasync, then wakes every waiter in the group
+class TransactionLog {
+private:
+    string path;
+    int fd;
+    size_t maxBatch;
+    mutex lock;
+    mutex fileLock; // held while the file is written, synced or replaced
+    condition_variable pendingReady, durableAdvanced;
+    vector<LogRecord> pending;
+    uint64_t nextLsn = 1;
+    uint64_t durableLsn = 0;
+    uint64_t groups = 0;
+    uint64_t recordsWritten = 0;
+    bool stopping = false;
+    thread committer;
+
+    void commitLoop() {
+        vector<LogRecord> group;
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            pendingReady.wait(guard, [&] { return stopping || !pending.empty(); });
+            if (pending.empty()) return;
+            size_t take = min(maxBatch, pending.size());
+            group.assign(pending.begin(), pending.begin() + take);
+            pending.erase(pending.begin(), pending.begin() + take);
+            guard.unlock();
+
+            // A journal that cannot write or sync must stop the bank, so these throw
+            // on the committer thread and terminate rather than acknowledge anything
+            {
+                lock_guard<mutex> fileGuard(fileLock);
+                const char* bytes = reinterpret_cast<const char*>(group.data());
+                size_t remaining = group.size() * sizeof(LogRecord);
+                while (remaining > 0) {
+                    ssize_t written = ::write(fd, bytes, remaining);
+                    if (written < 0) throw runtime_error("Write-ahead log write failed");
+                    bytes += written;
+                    remaining -= static_cast<size_t>(written);
+                }
+                if (fdatasync(fd) != 0) throw runtime_error("Write-ahead log sync failed");
+            }
+
+            guard.lock();
+            durableLsn = group.back().lsn;
+            ++groups;
+            recordsWritten += group.size();
+            durableAdvanced.notify_all();
+        }
+    }
+
+    static void copyName(char (&field)[16], const string& name) {
+        if (!canRecord(name)) throw invalid_argument("Account number too long for the journal: " + name);
+        memset(field, 0, sizeof(field));
+        memcpy(field, name.data(), name.size());
+    }
+
+public:
+    // Account numbers are stored whole, NUL-terminated, in a 16-byte field
+    static bool canRecord(const string& accountNumber) {
+        return accountNumber.size() < sizeof(LogRecord::account);
+    }
+
+    // Reopening continues after the last intact record; a torn tail is cut off, while
+    // damage before the tail refuses to open (see readIntact)
+    TransactionLog(const string& path, size_t maxBatch) : path(path), maxBatch(max<size_t>(1, maxBatch)) {
+        vector<LogRecord> existing = readIntact(path);
+        fd = open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (fd < 0) throw runtime_error("Cannot open write-ahead log: " + path);
+        if (ftruncate(fd, existing.size() * sizeof(LogRecord)) != 0 || lseek(fd, 0, SEEK_END) < 0) {
+            close(fd);
+            throw runtime_error("Cannot reposition write-ahead log: " + path);
+        }
+        if (!existing.empty()) {
+            durableLsn = existing.back().lsn;
+            nextLsn = durableLsn + 1;
+        }
+        committer = thread(&TransactionLog::commitLoop, this);
+    }
+
+    ~TransactionLog() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        pendingReady.notify_all();
+        committer.join();
+        close(fd);
+    }
+
+    // Returns the record's LSN; call waitDurable(lsn) before acknowledging the customer
+    uint64_t append(LogOp op, const string& account, const string& target, int64_t amount) {
+        LogRecord record{};
+        record.op = op;
+        record.amount = amount;
+        copyName(record.account, account);
+        copyName(record.target, target);
+        {
+            lock_guard<mutex> guard(lock);
+            record.lsn = nextLsn++;
+            record.checksum = record.computeChecksum();
+            pending.push_back(record);
+        }
+        pendingReady.notify_one();
+        return record.lsn;
+    }
+
+    void waitDurable(uint64_t lsn) {
+        unique_lock<mutex> guard(lock);
+        durableAdvanced.wait(guard, [&] { return durableLsn >= lsn; });
+    }
+
+    uint64_t lastAppendedLsn() {
+        lock_guard<mutex> guard(lock);
+        return nextLsn - 1;
+    }
+
+    // Rewrites the log without the records before `lsn`, once a checkpoint covers them.
+    // Record `lsn` itself is kept so a reopened log carries on numbering after it.
+    // The trimmed copy is synced and renamed over the log, so a crash leaves either
+    // file, and recovery skips covered records in both. Appends queue up meanwhile.
+    void trimBefore(uint64_t lsn) {
+        lock_guard<mutex> fileGuard(fileLock);
+        vector<LogRecord> records = readIntact(path);
+        auto keep = find_if(records.begin(), records.end(), [&](const LogRecord& r) { return r.lsn >= lsn; });
+        if (keep == records.begin() || keep == records.end()) return;
+
+        string temporary = path + ".tmp";
+        int trimmed = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (trimmed < 0) throw runtime_error("Cannot write trimmed log: " + temporary);
+        const char* bytes = reinterpret_cast<const char*>(&*keep);
+        size_t remaining = (records.end() - keep) * sizeof(LogRecord);
+        while (remaining > 0) {
+            ssize_t written = ::write(trimmed, bytes, remaining);
+            if (written < 0) {
+                close(trimmed);
+                throw runtime_error("Cannot write trimmed log: " + temporary);
+            }
+            bytes += written;
+            remaining -= static_cast<size_t>(written);
+        }
+        if (fsync(trimmed) != 0 || rename(temporary.c_str(), path.c_str()) != 0) {
+            close(trimmed);
+            throw runtime_error("Cannot replace write-ahead log: " + path);
+        }
+        syncParentDirectory(path);
+        close(fd);
+        fd = trimmed; // positioned at the end of the kept records
+    }
+
+    double averageGroupSize() {
+        lock_guard<mutex> guard(lock);
+        return groups ? static_cast<double>(recordsWritten) / groups : 0;
+    }
+
+    // Every record before a torn tail. A crash can only tear the last record, so a short
+    // or failing final record is dropped; a failing record with more data after it is
+    // corruption of durable records, and throws rather than discard what follows.
+    static vector<LogRecord> readIntact(const string& path) {
+        vector<LogRecord> records;
+        ifstream in(path, ios::binary);
+        LogRecord record;
+        while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            if (record.checksum != record.computeChecksum()) {
+                if (in.peek() != char_traits<char>::eof()) {
+                    throw runtime_error("Write-ahead log corrupt before its tail at record " + to_string(records.size() + 1)
+                                        + ": " + path);
+                }
+                break;
+            }
+            records.push_back(record);
+        }
+        return records;
+    }
+};
+
+// --- Velocity Checks: per-card sliding windows in a sharded hash table ---
+
+enum class FraudDecision { ALLOW, TOO_MANY_WITHDRAWALS, DAILY_AMOUNT_EXCEEDED, INVALID_AMOUNT };
+
+struct VelocityRules {
+    uint32_t maxWithdrawalsPerHour;
+    int64_t maxCentsPerDay;
+};
+
+// Each card keeps two rings of buckets: withdrawals per 5 minutes over the last hour,
+// and cents per hour over the last day. A check sums a fixed 12 + 24 buckets, so it
+// is O(1) whatever the card's history.
+class VelocityGuard {
+private:
+    static const uint32_t COUNT_BUCKETS = 12; // 5-minute buckets
+    static const uint32_t AMOUNT_BUCKETS = 24; // 1-hour buckets
+    static const size_t SHARDS = 64;
+
+    struct CardWindow {
+        uint64_t cardKey = 0; // 0 marks an empty slot
+        uint32_t lastMinute = 0; // minutes since the epoch of the last update
+        uint16_t counts[COUNT_BUCKETS] = {};
+        uint32_t cents[AMOUNT_BUCKETS] = {};
+    };
+
+    // Open addressing with linear probing, at most half full
+    struct Shard {
+        mutex lock;
+        vector<CardWindow> slots = vector<CardWindow>(16);
+        size_t used = 0;
+    };
+
+    array<Shard, SHARDS> shards;
+    atomic<uint32_t> maxPerHour;
+    atomic<int64_t> maxPerDay;
+    uint64_t key0, key1;
+
+    // Bit 0 of a key is always set, so the shard comes from bits 1-6 and the slot within
+    // it from bit 7 up
+    Shard& shardFor(uint64_t key) {
+        return shards[(key >> 1) % SHARDS];
+    }
+
+    static CardWindow& locate(Shard& shard, uint64_t key) {
+        size_t mask = shard.slots.size() - 1;
+        size_t i = (key >> 7) & mask;
+        while (shard.slots[i].cardKey != 0 && shard.slots[i].cardKey != key) i = (i + 1) & mask;
+        return shard.slots[i];
+    }
+
+    static void grow(Shard& shard) {
+        vector<CardWindow> old(shard.slots.size() * 2);
+        old.swap(shard.slots);
+        for (const CardWindow& window : old) {
+            if (window.cardKey != 0) locate(shard, window.cardKey) = window;
+        }
+    }
+
+    // Clears buckets the window has moved past since the card's last update
+    static void advance(CardWindow& window, uint32_t minute) {
+        if (minute <= window.lastMinute) return;
+        uint32_t oldSlot = window.lastMinute / 5, newSlot = minute / 5;
+        for (uint32_t s = oldSlot + 1; s <= newSlot && s <= oldSlot + COUNT_BUCKETS; ++s) window.counts[s % COUNT_BUCKETS] = 0;
+        uint32_t oldHour = window.lastMinute / 60, newHour = minute / 60;
+        for (uint32_t h = oldHour + 1; h <= newHour && h <= oldHour + AMOUNT_BUCKETS; ++h) window.cents[h % AMOUNT_BUCKETS] = 0;
+        window.lastMinute = minute;
+    }
+
+public:
+    explicit VelocityGuard(VelocityRules rules) {
+        setRules(rules);
+        mt19937_64 seed(random_device{}());
+        key0 = seed();
+        key1 = seed();
+    }
+
+    // Takes effect for the next check on any thread
+    void setRules(VelocityRules rules) {
+        maxPerHour.store(rules.maxWithdrawalsPerHour, memory_order_relaxed);
+        maxPerDay.store(rules.maxCentsPerDay, memory_order_relaxed);
+    }
+
+    // Checks the withdrawal against both windows and, if allowed, counts it
+    FraudDecision checkWithdrawal(const string& cardNumber, int64_t cents, time_t now) {
+        if (cents <= 0) return FraudDecision::INVALID_AMOUNT; // never counted, so a typo cannot block the card
+        uint64_t key = sipHash24(key0, key1, cardNumber.data(), cardNumber.size()) | 1;
+        Shard& shard = shardFor(key);
+        uint32_t minute = static_cast<uint32_t>(now / 60);
+        lock_guard<mutex> guard(shard.lock);
+        if ((shard.used + 1) * 2 > shard.slots.size()) grow(shard);
+        CardWindow& window = locate(shard, key);
+        if (window.cardKey == 0) {
+            window.cardKey = key;
+            window.lastMinute = minute;
+            ++shard.used;
+        }
+        advance(window, minute);
+
+        uint32_t withdrawals = 0;
+        for (uint16_t count : window.counts) withdrawals += count;
+        int64_t spent = 0;
+        for (uint32_t c : window.cents) spent += c;
+        if (withdrawals + 1 > maxPerHour.load(memory_order_relaxed)) return FraudDecision::TOO_MANY_WITHDRAWALS;
+        if (spent + cents > maxPerDay.load(memory_order_relaxed)) return FraudDecision::DAILY_AMOUNT_EXCEEDED;
+        // An hour bucket holds up to $42.9M; more than that in one hour is over any sane daily limit
+        uint32_t& hourCents = window.cents[(minute / 60) % AMOUNT_BUCKETS];
+        if (cents > static_cast<int64_t>(UINT32_MAX - hourCents)) return FraudDecision::DAILY_AMOUNT_EXCEEDED;
+        ++window.counts[(minute / 5) % COUNT_BUCKETS];
+        hourCents += static_cast<uint32_t>(cents);
+        return FraudDecision::ALLOW;
+    }
+
+    // Gives back a withdrawal that checkWithdrawal allowed at `now` but that did not go
+    // ahead. Buckets the window has since moved past are already cleared and left alone.
+    void releaseWithdrawal(const string& cardNumber, int64_t cents, time_t now) {
+        if (cents <= 0) return;
+        uint64_t key = sipHash24(key0, key1, cardNumber.data(), cardNumber.size()) | 1;
+        Shard& shard = shardFor(key);
+        uint32_t minute = static_cast<uint32_t>(now / 60);
+        lock_guard<mutex> guard(shard.lock);
+        CardWindow& window = locate(shard, key);
+        if (window.cardKey == 0) return;
+        if (window.lastMinute / 5 < minute / 5 + COUNT_BUCKETS) {
+            uint16_t& count = window.counts[(minute / 5) % COUNT_BUCKETS];
+            if (count > 0) --count;
+        }
+        if (window.lastMinute / 60 < minute / 60 + AMOUNT_BUCKETS) {
+            uint32_t& hourCents = window.cents[(minute / 60) % AMOUNT_BUCKETS];
+            hourCents -= static_cast<uint32_t>(min<int64_t>(hourCents, cents));
         }
-        cout << "Withdrawal failed. Insufficient funds or invalid amount." << endl;
-        return false;
     }
 };
 
@@ -61,8 +689,32 @@ class Bank {
 private:
     // A map to link card numbers to bank accounts
     map<string, BankAccount*> accounts;
-    // A map to store card number and PIN for authentication
-    map<string, string> cardPinMap;
+    // Salted PIN digests with lockout counters, keyed by card number hash
+    CredentialStore credentials;
+    // Accounts by account number, for the journal and recovery
+    map<string, BankAccount*> accountsByNumber;
+    // Every money movement is journaled here when attached
+    unique_ptr<TransactionLog> journal;
+    // Withdrawal velocity limits per card: 5 per hour, $1,000 per day by default
+    VelocityGuard velocity{VelocityRules{5, 100000}};
+
+    // Applies a change, journaling it under the account lock(s), then waits until
+    // the record is durable. Locks are released before the wait, so other sessions
+    // can join the same group commit.
+    template <typename Apply>
+    bool applyJournaled(LogOp op, const BankAccount& account, const BankAccount* target, int64_t cents, Apply apply) {
+        if (!journal) return apply(nullptr);
+        // Checked before the balance changes, since append runs after it under the lock
+        if (!TransactionLog::canRecord(account.getAccountNumber()) || (target && !TransactionLog::canRecord(target->getAccountNumber()))) {
+            throw invalid_argument("Account number too long for the journal");
+        }
+        uint64_t lsn = 0;
+        bool applied = apply([&] {
+            lsn = journal->append(op, account.getAccountNumber(), target ? target->getAccountNumber() : "", cents);
+        });
+        if (applied) journal->waitDurable(lsn);
+        return applied;
+    }
 
     // Private constructor for Singleton
     Bank() {}
@@ -79,29 +731,313 @@ public:
     }
 
     // Add account and card details for simulation
+    // One account may have several cards; two accounts may not share a number
     void addAccount(BankAccount* account, Card* card, const string& pin) {
+        auto existing = accountsByNumber.find(account->getAccountNumber());
+        if (existing != accountsByNumber.end() && existing->second != account) {
+            throw invalid_argument("Duplicate account number " + account->getAccountNumber());
+        }
         accounts[card->getCardNumber()] = account;
-        cardPinMap[card->getCardNumber()] = pin;
+        credentials.enroll(card->getCardNumber(), pin);
+        accountsByNumber[account->getAccountNumber()] = account;
+    }
+
+    // Money movements that survive a crash once they return true
+    bool deposit(BankAccount& account, int64_t cents) {
+        return applyJournaled(LogOp::DEPOSIT, account, nullptr, cents,
+                              [&](const function<void()>& log) { return account.deposit(cents, log); });
+    }
+
+    bool withdraw(BankAccount& account, int64_t cents) {
+        return applyJournaled(LogOp::WITHDRAW, account, nullptr, cents,
+                              [&](const function<void()>& log) { return account.withdraw(cents, log); });
+    }
+
+    bool transfer(BankAccount& from, BankAccount& to, int64_t cents) {
+        return applyJournaled(LogOp::TRANSFER, from, &to, cents,
+                              [&](const function<void()>& log) { return BankAccount::transfer(from, to, cents, log); });
+    }
+
+    // Run before a withdrawal is executed. An allowed withdrawal is counted straight
+    // away, so concurrent sessions cannot both slip under a limit; if the withdrawal
+    // then fails, releaseWithdrawal with the same `now` gives the allowance back.
+    FraudDecision authorizeWithdrawal(const string& cardNumber, int64_t cents, time_t now = time(0)) {
+        return velocity.checkWithdrawal(cardNumber, cents, now);
+    }
+
+    void releaseWithdrawal(const string& cardNumber, int64_t cents, time_t now) {
+        velocity.releaseWithdrawal(cardNumber, cents, now);
+    }
+
+    void setVelocityRules(VelocityRules rules) {
+        velocity.setRules(rules);
+    }
+
+    void attachJournal(const string& path, size_t maxBatch) {
+        journal = make_unique<TransactionLog>(path, maxBatch);
+    }
+
+    void detachJournal() {
+        journal.reset();
+    }
+
+    // Writes every balance as of one LSN. All accounts are locked for a consistent cut,
+    // and the snapshot is only written once the log covers that LSN. The file is synced
+    // before it replaces the old checkpoint and the directory after, so a crash leaves
+    // one complete checkpoint or the other. A trailing CRC lets recovery verify it.
+    void checkpoint(const string& path) {
+        vector<BankAccount*> all;
+        for (auto const& [number, account] : accountsByNumber) all.push_back(account);
+        vector<pair<string, int64_t>> balances;
+        uint64_t lsn = 0;
+        {
+            auto guards = BankAccount::lockAll(all);
+            for (BankAccount* account : all) balances.push_back({account->getAccountNumber(), account->balanceWhileLocked()});
+            if (journal) lsn = journal->lastAppendedLsn();
+        }
+        if (journal) journal->waitDurable(lsn);
+
+        string text = to_string(lsn) + "\n";
+        for (const auto& [number, cents] : balances) text += number + " " + to_string(cents) + "\n";
+        text += "crc " + to_string(crc32(text.data(), text.size())) + "\n";
+
+        string temporary = path + ".tmp";
+        int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw runtime_error("Cannot write checkpoint: " + temporary);
+        for (size_t done = 0; done < text.size();) {
+            ssize_t written = ::write(fd, text.data() + done, text.size() - done);
+            if (written < 0) {
+                close(fd);
+                throw runtime_error("Cannot write checkpoint: " + temporary);
+            }
+            done += static_cast<size_t>(written);
+        }
+        bool synced = fsync(fd) == 0;
+        close(fd);
+        if (!synced) throw runtime_error("Cannot sync checkpoint: " + temporary);
+        if (rename(temporary.c_str(), path.c_str()) != 0) throw runtime_error("Cannot replace checkpoint: " + path);
+        syncParentDirectory(path);
+
+        // The checkpoint now covers everything up to `lsn`, so the log can drop it
+        if (journal) journal->trimBefore(lsn);
+    }
+
+    // Startup: balances from the checkpoint, then every intact journal record after it.
+    // Returns how many records were replayed.
+    size_t recover(const string& checkpointPath, const string& journalPath) {
+        uint64_t checkpointLsn = 0;
+        ifstream file(checkpointPath, ios::binary);
+        if (file) {
+            // Trust the checkpoint only if its CRC line matches everything above it
+            string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+            size_t trailer = text.rfind("crc ");
+            if (trailer == string::npos || (trailer > 0 && text[trailer - 1] != '\n')
+                || text.substr(trailer) != "crc " + to_string(crc32(text.data(), trailer)) + "\n") {
+                throw runtime_error("Corrupt checkpoint: " + checkpointPath);
+            }
+            istringstream in(text.substr(0, trailer));
+            if (!(in >> checkpointLsn)) throw runtime_error("Corrupt checkpoint: " + checkpointPath);
+            string number;
+            int64_t cents;
+            while (in >> number >> cents) {
+                auto it = accountsByNumber.find(number);
+                if (it == accountsByNumber.end()) {
+                    throw runtime_error("Checkpoint names an unknown account: " + number);
+                }
+                it->second->restoreBalance(cents);
+            }
+            if (!in.eof()) throw runtime_error("Corrupt checkpoint: " + checkpointPath);
+        }
+        size_t replayed = 0;
+        for (const LogRecord& record : TransactionLog::readIntact(journalPath)) {
+            if (record.lsn <= checkpointLsn) continue;
+            // Every record was acknowledged to a customer, so one that cannot be applied stops recovery
+            auto account = accountsByNumber.find(record.account);
+            if (account == accountsByNumber.end()) {
+                throw runtime_error("Journal record " + to_string(record.lsn) + " names an unknown account: " + record.account);
+            }
+            bool applied = false;
+            switch (record.op) {
+                case LogOp::DEPOSIT: applied = account->second->deposit(record.amount); break;
+                case LogOp::WITHDRAW: applied = account->second->withdraw(record.amount); break;
+                case LogOp::TRANSFER: {
+                    auto target = accountsByNumber.find(record.target);
+                    if (target == accountsByNumber.end()) {
+                        throw runtime_error("Journal record " + to_string(record.lsn) + " names an unknown account: " + record.target);
+                    }
+                    applied = BankAccount::transfer(*account->second, *target->second, record.amount);
+                    break;
+                }
+            }
+            if (!applied) {
+                throw runtime_error("Journal record " + to_string(record.lsn) + " cannot be applied to " + record.account);
+            }
+            ++replayed;
+        }
+        return replayed;
     }
     
     bool authenticateUser(const string& cardNumber, const string& pin) {
-        if (cardPinMap.count(cardNumber) && cardPinMap[cardNumber] == pin) {
+        AuthResult result = verifyPin(cardNumber, pin);
+        if (result == AuthResult::OK) {
             cout << "Authentication successful." << endl;
             return true;
         }
-        cout << "Authentication failed: Invalid card number or PIN." << endl;
+        if (result == AuthResult::LOCKED) {
+            cout << "Authentication failed: Card locked after too many wrong PINs." << endl;
+        } else {
+            cout << "Authentication failed: Invalid card number or PIN." << endl;
+        }
         return false;
     }
 
-    BankAccount* getAccount(const string& cardNumber) {
-        if (accounts.count(cardNumber)) {
-            return accounts[cardNumber];
-        }
-        return nullptr;
+    // Silent check for servers; safe from many threads once accounts are set up
+    AuthResult verifyPin(const string& cardNumber, const string& pin) const {
+        return credentials.verify(cardNumber, pin);
+    }
+
+    void unlockCard(const string& cardNumber) {
+        credentials.unlock(cardNumber);
+    }
+
+    BankAccount* getAccount(const string& cardNumber) const {
+        auto it = accounts.find(cardNumber);
+        return it != accounts.end() ? it->second : nullptr;
     }
 };
 
 
+// --- Cash Dispenser: note counts per cassette and a bounded change-making DP ---
+
+// best[i][a] is the cheapest way to pay `a` units (the gcd of the denominations) from
+// the first i cassettes, respecting how many notes each holds. Each note costs
+// NOTE_COST. Notes from a cassette below its reserve cost up to twice that, so the DP
+// spends scarce notes last. Layer i+1 depends only on layer i and cassette i. After a
+// dispense, rebuilding starts at the first cassette whose usable count or note cost
+// actually changed. While cassettes are well stocked, nothing is rebuilt.
+class CashDispenser {
+public:
+    struct Cassette {
+        int64_t denomination; // cents
+        uint32_t count;
+    };
+
+private:
+    static const uint32_t NOTE_COST = 100;
+    static const uint32_t UNREACHABLE = UINT32_MAX / 2;
+
+    vector<Cassette> cassettes;
+    uint32_t reserve; // notes below which a cassette counts as running low
+    int64_t unit; // cents
+    uint32_t maxUnits; // largest single dispense
+    vector<vector<uint32_t>> best;
+    vector<vector<uint16_t>> take; // notes taken from cassette i-1 in best[i][a]
+    vector<pair<uint32_t, uint32_t>> builtWith; // (usable notes, note cost) per layer
+    uint64_t layersRebuilt = 0;
+
+    uint32_t unitsOf(size_t i) const {
+        return static_cast<uint32_t>(cassettes[i].denomination / unit);
+    }
+
+    uint32_t usableNotes(size_t i) const {
+        return min(cassettes[i].count, maxUnits / unitsOf(i));
+    }
+
+    uint32_t noteCost(size_t i) const {
+        uint32_t count = cassettes[i].count;
+        return count >= reserve ? NOTE_COST : NOTE_COST + NOTE_COST * (reserve - count) / reserve;
+    }
+
+    void buildLayer(size_t i) {
+        uint32_t d = unitsOf(i), limit = usableNotes(i), cost = noteCost(i);
+        const vector<uint32_t>& previous = best[i];
+        vector<uint32_t>& current = best[i + 1];
+        vector<uint16_t>& taken = take[i + 1];
+        for (uint32_t a = 0; a <= maxUnits; ++a) {
+            uint32_t bestCost = previous[a];
+            uint16_t bestNotes = 0;
+            uint32_t most = min(limit, a / d);
+            for (uint32_t k = 1; k <= most; ++k) {
+                uint32_t candidate = previous[a - k * d] + k * cost;
+                if (candidate < bestCost) {
+                    bestCost = candidate;
+                    bestNotes = static_cast<uint16_t>(k);
+                }
+            }
+            current[a] = bestCost;
+            taken[a] = bestNotes;
+        }
+        builtWith[i] = {limit, cost};
+        ++layersRebuilt;
+    }
+
+    void refresh(bool force) {
+        bool stale = force;
+        for (size_t i = 0; i < cassettes.size(); ++i) {
+            stale = stale || builtWith[i] != make_pair(usableNotes(i), noteCost(i));
+            if (stale) buildLayer(i);
+        }
+    }
+
+public:
+    CashDispenser(vector<Cassette> loaded, int64_t maxDispenseCents, uint32_t reserveNotes)
+        : cassettes(move(loaded)), reserve(max(1u, reserveNotes)) {
+        if (cassettes.empty()) throw invalid_argument("A dispenser needs at least one cassette");
+        unit = 0;
+        for (const Cassette& c : cassettes) {
+            if (c.denomination <= 0) throw invalid_argument("Denominations must be positive");
+            unit = unit == 0 ? c.denomination : gcd(unit, c.denomination);
+        }
+        maxUnits = static_cast<uint32_t>(maxDispenseCents / unit);
+        // take[] stores notes per cassette in 16 bits
+        for (size_t i = 0; i < cassettes.size(); ++i) {
+            if (maxUnits / unitsOf(i) > UINT16_MAX) throw invalid_argument("Too many notes per dispense for one cassette");
+        }
+        best.assign(cassettes.size() + 1, vector<uint32_t>(maxUnits + 1, UNREACHABLE));
+        take.assign(cassettes.size() + 1, vector<uint16_t>(maxUnits + 1, 0));
+        best[0][0] = 0;
+        builtWith.assign(cassettes.size(), {0, 0});
+        refresh(true);
+    }
+
+    // Notes per cassette for `cents`, or nothing if the cash on hand cannot make it
+    optional<vector<uint32_t>> plan(int64_t cents) const {
+        if (cents <= 0 || cents % unit != 0 || cents / unit > maxUnits) return nullopt;
+        uint32_t a = static_cast<uint32_t>(cents / unit);
+        if (best.back()[a] >= UNREACHABLE) return nullopt;
+        vector<uint32_t> notes(cassettes.size(), 0);
+        for (size_t i = cassettes.size(); i > 0; --i) {
+            notes[i - 1] = take[i][a];
+            a -= take[i][a] * unitsOf(i - 1);
+        }
+        return notes;
+    }
+
+    // Removes the planned notes and brings the tables up to date
+    void commit(const vector<uint32_t>& notes) {
+        for (size_t i = 0; i < cassettes.size(); ++i) cassettes[i].count -= notes[i];
+        refresh(false);
+    }
+
+    void refill(size_t cassette, uint32_t count) {
+        cassettes.at(cassette).count = count;
+        refresh(false);
+    }
+
+    string describe(const vector<uint32_t>& notes) const {
+        string text;
+        for (size_t i = 0; i < cassettes.size(); ++i) {
+            if (notes[i] == 0) continue;
+            if (!text.empty()) text += ", ";
+            text += to_string(notes[i]) + " x " + formatMoney(cassettes[i].denomination);
+        }
+        return text;
+    }
+
+    const vector<Cassette>& getCassettes() const { return cassettes; }
+    uint64_t getLayersRebuilt() const { return layersRebuilt; }
+};
+
 // --- Strategy Pattern for Transactions ---
 
 // Abstract base class for all transactions
@@ -117,7 +1053,7 @@ public:
     void execute(BankAccount* account) override {
         cout << "--- Balance Inquiry ---" << endl;
         if (account) {
-            cout << "Current Balance: $" << account->getBalance() << endl;
+            cout << "Current Balance: " << formatMoney(account->getBalance()) << endl;
         }
     }
 };
@@ -125,15 +1061,52 @@ public:
 // Concrete Strategy: Withdraw Transaction
 class WithdrawTransaction : public Transaction {
 private:
-    double amount;
+    int64_t amount; // cents
+    CashDispenser* dispenser; // the ATM's cash, or nullptr when no cash is handed out
+    string cardNumber; // checked against the card's velocity limits; empty to skip
 
 public:
-    WithdrawTransaction(double amt) : amount(amt) {}
+    WithdrawTransaction(int64_t cents, CashDispenser* cash = nullptr, const string& card = "")
+        : amount(cents), dispenser(cash), cardNumber(card) {}
 
     void execute(BankAccount* account) override {
         cout << "--- Withdrawal ---" << endl;
         if (account) {
-            account->withdraw(amount);
+            Bank& bank = Bank::getInstance();
+            if (amount <= 0) {
+                cout << "Withdrawal failed. Invalid amount." << endl;
+                return;
+            }
+            // Plan the notes first, so the account is only debited for cash the ATM can pay
+            optional<vector<uint32_t>> notes;
+            if (dispenser && !(notes = dispenser->plan(amount))) {
+                cout << "Withdrawal failed. This ATM cannot dispense " << formatMoney(amount) << "." << endl;
+                return;
+            }
+            // Limits are checked last, so only a withdrawal that can really happen uses them up
+            time_t now = time(0);
+            if (!cardNumber.empty()) {
+                switch (bank.authorizeWithdrawal(cardNumber, amount, now)) {
+                    case FraudDecision::ALLOW:
+                        break;
+                    case FraudDecision::INVALID_AMOUNT:
+                        cout << "Withdrawal failed. Invalid amount." << endl;
+                        return;
+                    default:
+                        cout << "Withdrawal declined: card has reached its withdrawal limits." << endl;
+                        return;
+                }
+            }
+            if (bank.withdraw(*account, amount)) {
+                if (notes) {
+                    dispenser->commit(*notes);
+                    cout << "Dispensing " << dispenser->describe(*notes) << endl;
+                }
+                cout << "Withdrawal successful. New balance: " << formatMoney(account->getBalance()) << endl;
+            } else {
+                if (!cardNumber.empty()) bank.releaseWithdrawal(cardNumber, amount, now);
+                cout << "Withdrawal failed. Insufficient funds or invalid amount." << endl;
+            }
         }
     }
 };
@@ -141,15 +1114,43 @@ public:
 // Concrete Strategy: Deposit Transaction
 class DepositTransaction : public Transaction {
 private:
-    double amount;
+    int64_t amount; // cents
 
 public:
-    DepositTransaction(double amt) : amount(amt) {}
+    DepositTransaction(int64_t cents) : amount(cents) {}
 
     void execute(BankAccount* account) override {
         cout << "--- Deposit ---" << endl;
         if (account) {
-            account->deposit(amount);
+            if (Bank::getInstance().deposit(*account, amount)) {
+                cout << "Deposit successful. New balance: " << formatMoney(account->getBalance()) << endl;
+            } else {
+                cout << "Deposit failed. Invalid amount." << endl;
+            }
+        }
+    }
+};
+
+// Concrete Strategy: Transfer Transaction
+class TransferTransaction : public Transaction {
+private:
+    BankAccount* target;
+    int64_t amount; // cents
+
+public:
+    TransferTransaction(BankAccount* to, int64_t cents) : target(to), amount(cents) {}
+
+    void execute(BankAccount* account) override {
+        cout << "--- Transfer ---" << endl;
+        if (account && target) {
+            if (Bank::getInstance().transfer(*account, *target, amount)) {
+                cout << "Transferred " << formatMoney(amount) << " to " << target->getAccountNumber()
+                     << ". New balance: " << formatMoney(account->getBalance()) << endl;
+            } else {
+                cout << "Transfer failed. Insufficient funds or invalid amount." << endl;
+            }
+        } else {
+            cout << "Transfer failed. Unknown target account." << endl;
         }
     }
 };
@@ -163,9 +1164,11 @@ private:
     ATMState currentState;
     Card* currentCard;
     Bank& bank; // Reference to the singleton bank
+    CashDispenser cash; // $100, $50, $20 and $10 cassettes; at most $1,000 per withdrawal
 
 public:
-    ATM() : currentState(ATMState::IDLE), currentCard(nullptr), bank(Bank::getInstance()) {
+    ATM() : currentState(ATMState::IDLE), currentCard(nullptr), bank(Bank::getInstance()),
+            cash({{10000, 500}, {5000, 500}, {2000, 1000}, {1000, 1000}}, 100000, 100) {
         cout << "ATM is now online. State: IDLE" << endl;
     }
 
@@ -202,7 +1205,8 @@ public:
         cout << "1. Check Balance" << endl;
         cout << "2. Withdraw" << endl;
         cout << "3. Deposit" << endl;
-        cout << "4. Exit" << endl;
+        cout << "4. Transfer" << endl;
+        cout << "5. Exit" << endl;
         
         int choice;
         cin >> choice;
@@ -210,6 +1214,7 @@ public:
         Transaction* transaction = nullptr;
         BankAccount* account = bank.getAccount(currentCard->getCardNumber());
         double amount;
+        string targetCard;
 
         switch (choice) {
             case 1:
@@ -218,14 +1223,19 @@ public:
             case 2:
                 cout << "Enter amount to withdraw: ";
                 cin >> amount;
-                transaction = new WithdrawTransaction(amount);
+                transaction = new WithdrawTransaction(toCents(amount), &cash, currentCard->getCardNumber());
                 break;
             case 3:
                 cout << "Enter amount to deposit: ";
                 cin >> amount;
-                transaction = new DepositTransaction(amount);
+                transaction = new DepositTransaction(toCents(amount));
                 break;
             case 4:
+                cout << "Enter target card number and amount: ";
+                cin >> targetCard >> amount;
+                transaction = new TransferTransaction(bank.getAccount(targetCard), toCents(amount));
+                break;
+            case 5:
                 cout << "Exiting..." << endl;
                 ejectCard();
                 return;
@@ -252,19 +1262,582 @@ public:
 };
 
 
+// --- Settlement Engine: end-of-day batches partitioned by account ---
+
+enum class SettlementOp : uint8_t { DEPOSIT, WITHDRAW, TRANSFER };
+
+// 24-byte POD; accounts are dense indexes into the settlement ledger
+struct SettlementTx {
+    uint32_t account;
+    uint32_t target; // transfers only
+    int64_t amount; // cents
+    SettlementOp op;
+};
+
+// Each transaction becomes one leg per touched account: a transfer has a debit leg in
+// the source's partition and a credit leg in the target's. Every partition runs its
+// legs in batch order, so each account sees its transactions in their original
+// order, and no ledger entry is shared between threads. A credit leg waits for its
+// debit leg's outcome. The lowest unfinished transaction can always proceed, so the
+// wait cannot deadlock.
+class SettlementEngine {
+private:
+    enum : uint8_t { PENDING = 0, APPLIED = 1, REJECTED = 2 };
+    static const uint32_t ACCOUNTS_PER_LINE = 64 / sizeof(int64_t);
+
+    vector<int64_t>& ledger;
+    unsigned partitions;
+
+    // Neighbouring accounts share a cache line, so whole lines go to one partition
+    unsigned partitionOf(uint32_t account) const {
+        return (account / ACCOUNTS_PER_LINE) % partitions;
+    }
+
+public:
+    SettlementEngine(vector<int64_t>& ledger, unsigned partitions) : ledger(ledger), partitions(max(1u, partitions)) {}
+
+    // Returns the number of transactions applied; the rest were rejected for funds, a
+    // non-positive amount or a transfer to the same account (as BankAccount does).
+    // A transaction naming an account outside the ledger fails the whole batch up front.
+    size_t settle(const vector<SettlementTx>& batch) {
+        for (const SettlementTx& tx : batch) {
+            if (tx.account >= ledger.size() || (tx.op == SettlementOp::TRANSFER && tx.target >= ledger.size())
+                || tx.op > SettlementOp::TRANSFER) {
+                throw invalid_argument("Settlement batch names an account outside the ledger");
+            }
+        }
+
+        vector<vector<uint64_t>> legs(partitions); // (transaction index << 1) | isCredit
+        for (auto& list : legs) list.reserve(batch.size() / partitions + 1);
+        for (uint64_t i = 0; i < batch.size(); ++i) {
+            legs[partitionOf(batch[i].account)].push_back(i << 1);
+            if (batch[i].op == SettlementOp::TRANSFER) legs[partitionOf(batch[i].target)].push_back(i << 1 | 1);
+        }
+
+        unique_ptr<atomic<uint8_t>[]> outcome(new atomic<uint8_t>[batch.size()]);
+        for (size_t i = 0; i < batch.size(); ++i) outcome[i].store(PENDING, memory_order_relaxed);
+        vector<size_t> applied(partitions, 0);
+
+        auto runPartition = [&](unsigned p) {
+            size_t count = 0;
+            for (uint64_t leg : legs[p]) {
+                size_t i = leg >> 1;
+                const SettlementTx& tx = batch[i];
+                if (leg & 1) {
+                    uint8_t debit;
+                    while ((debit = outcome[i].load(memory_order_acquire)) == PENDING) this_thread::yield();
+                    if (debit == APPLIED) ledger[tx.target] += tx.amount;
+                    continue;
+                }
+                bool ok = tx.amount > 0 && (tx.op != SettlementOp::TRANSFER || tx.target != tx.account)
+                    && (tx.op == SettlementOp::DEPOSIT || ledger[tx.account] >= tx.amount);
+                if (ok) ledger[tx.account] += tx.op == SettlementOp::DEPOSIT ? tx.amount : -tx.amount;
+                outcome[i].store(ok ? APPLIED : REJECTED, memory_order_release);
+                count += ok;
+            }
+            applied[p] = count;
+        };
+
+        vector<thread> workers;
+        for (unsigned p = 1; p < partitions; ++p) workers.emplace_back(runPartition, p);
+        runPartition(0);
+        for (thread& worker : workers) worker.join();
+
+        size_t total = 0;
+        for (size_t count : applied) total += count;
+        return total;
+    }
+};
+
+// The straightforward one-at-a-time settlement, used to check the engine
+size_t settleSequentially(vector<int64_t>& ledger, const vector<SettlementTx>& batch) {
+    size_t applied = 0;
+    for (const SettlementTx& tx : batch) {
+        if (tx.amount <= 0 || (tx.op == SettlementOp::TRANSFER && tx.target == tx.account)) continue;
+        if (tx.op != SettlementOp::DEPOSIT && ledger[tx.account] < tx.amount) continue;
+        ledger[tx.account] += tx.op == SettlementOp::DEPOSIT ? tx.amount : -tx.amount;
+        if (tx.op == SettlementOp::TRANSFER) ledger[tx.target] += tx.amount;
+        ++applied;
+    }
+    return applied;
+}
+
+void runSettlementBenchmark(uint32_t accountCount, size_t transactionCount, unsigned partitions) {
+    mt19937_64 rng(2024);
+    vector<SettlementTx> batch(transactionCount);
+    for (SettlementTx& tx : batch) {
+        tx.account = rng() % accountCount;
+        tx.target = rng() % accountCount;
+        tx.amount = 100 + rng() % 100000;
+        unsigned kind = rng() % 10;
+        tx.op = kind < 2 ? SettlementOp::DEPOSIT : kind < 4 ? SettlementOp::WITHDRAW : SettlementOp::TRANSFER;
+    }
+    vector<int64_t> ledger(accountCount, 200000), expected(accountCount, 200000);
+
+    auto start = chrono::steady_clock::now();
+    size_t applied = SettlementEngine(ledger, partitions).settle(batch);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    size_t expectedApplied = settleSequentially(expected, batch);
+    cout << transactionCount << " transactions over " << accountCount << " accounts, " << partitions
+         << " partition(s): " << transactionCount / seconds / 1e6 << " M tx/s, " << applied << " applied ("
+         << (applied == expectedApplied && ledger == expected ? "matches" : "DIFFERS from") << " sequential)" << endl;
+}
+
+// --- Session Server: many terminals as state machines on event loops ---
+
+enum class TerminalEvent : uint8_t { CARD_INSERTED, PIN_ENTERED, OPERATION_SELECTED };
+enum class TerminalOperation : uint8_t { BALANCE, WITHDRAW, DEPOSIT, TRANSFER, EXIT };
+enum class TerminalReply : uint8_t {
+    NONE, ENTER_PIN, SELECT_OPERATION, WRONG_PIN, CARD_RETAINED, DONE, DECLINED, LIMIT_REACHED, OUT_OF_SEQUENCE
+};
+
+const char* describe(TerminalReply reply) {
+    switch (reply) {
+        case TerminalReply::NONE: return "none";
+        case TerminalReply::ENTER_PIN: return "enter PIN";
+        case TerminalReply::SELECT_OPERATION: return "select operation";
+        case TerminalReply::WRONG_PIN: return "wrong PIN, try again";
+        case TerminalReply::CARD_RETAINED: return "card retained";
+        case TerminalReply::DONE: return "done";
+        case TerminalReply::DECLINED: return "declined";
+        case TerminalReply::LIMIT_REACHED: return "withdrawal limit reached";
+        case TerminalReply::OUT_OF_SEQUENCE: return "out of sequence";
+    }
+    return "unknown";
+}
+
+// One message from a terminal; no strings, so messages are copied around cheaply
+struct TerminalMessage {
+    uint32_t terminal;
+    TerminalEvent event;
+    TerminalOperation operation;
+    char pin[6]; // NUL-terminated, up to 5 digits
+    int64_t amount; // cents
+    const Card* card;
+    BankAccount* target; // for transfers
+};
+
+// Everything the server remembers about a terminal: 24 bytes
+struct TerminalState {
+    const Card* card = nullptr;
+    BankAccount* account = nullptr;
+    uint8_t state = 0; // ATM state: 0 idle, 1 card inserted, 2 authenticated
+    TerminalReply lastReply = TerminalReply::NONE;
+};
+
+// Terminals are partitioned across event loops (terminal % loops). Each loop owns
+// its terminals' state outright, so the state machines need no locks.
+class ATMSessionServer {
+private:
+    static const uint8_t IDLE = 0, CARD_INSERTED = 1, AUTHENTICATED = 2;
+
+    struct EventLoop {
+        mutex lock;
+        condition_variable changed;
+        vector<TerminalMessage> inbox;
+        bool stopping = false;
+        uint64_t submitted = 0;
+        uint64_t processed = 0;
+        uint64_t sessionsCompleted = 0; // written only by the loop thread
+        thread worker;
+    };
+
+    Bank& bank;
+    vector<TerminalState> terminals;
+    vector<unique_ptr<EventLoop>> loops;
+
+    TerminalReply runOperation(TerminalState& terminal, const TerminalMessage& message) {
+        BankAccount* account = terminal.account;
+        switch (message.operation) {
+            case TerminalOperation::BALANCE: return TerminalReply::DONE;
+            // With a journal attached these wait for the group commit, which stalls
+            // this loop's other terminals; run more loops than cores in that case
+            case TerminalOperation::WITHDRAW: {
+                time_t now = time(0);
+                switch (bank.authorizeWithdrawal(terminal.card->getCardNumber(), message.amount, now)) {
+                    case FraudDecision::ALLOW: break;
+                    case FraudDecision::INVALID_AMOUNT: return TerminalReply::DECLINED;
+                    default: return TerminalReply::LIMIT_REACHED;
+                }
+                if (bank.withdraw(*account, message.amount)) return TerminalReply::DONE;
+                bank.releaseWithdrawal(terminal.card->getCardNumber(), message.amount, now); // not taken, so not counted
+                return TerminalReply::DECLINED;
+            }
+            case TerminalOperation::DEPOSIT: return bank.deposit(*account, message.amount) ? TerminalReply::DONE : TerminalReply::DECLINED;
+            case TerminalOperation::TRANSFER:
+                return message.target && bank.transfer(*account, *message.target, message.amount)
+                    ? TerminalReply::DONE : TerminalReply::DECLINED;
+            case TerminalOperation::EXIT: return TerminalReply::DONE;
+        }
+        return TerminalReply::DECLINED;
+    }
+
+    // The same IDLE -> CARD_INSERTED -> AUTHENTICATED machine as the ATM class
+    void handle(EventLoop& loop, const TerminalMessage& message) {
+        TerminalState& terminal = terminals[message.terminal];
+        switch (message.event) {
+            case TerminalEvent::CARD_INSERTED:
+                if (terminal.state != IDLE || message.card == nullptr) {
+                    terminal.lastReply = TerminalReply::OUT_OF_SEQUENCE;
+                    return;
+                }
+                terminal.card = message.card;
+                terminal.account = bank.getAccount(message.card->getCardNumber());
+                terminal.state = CARD_INSERTED;
+                terminal.lastReply = TerminalReply::ENTER_PIN;
+                return;
+            case TerminalEvent::PIN_ENTERED:
+                if (terminal.state != CARD_INSERTED) {
+                    terminal.lastReply = TerminalReply::OUT_OF_SEQUENCE;
+                    return;
+                }
+                // Lockout counters live in the bank's credential store, so they
+                // follow the card across terminals and sessions
+                switch (terminal.account ? bank.verifyPin(terminal.card->getCardNumber(), message.pin)
+                                         : AuthResult::UNKNOWN_CARD) {
+                    case AuthResult::OK:
+                        terminal.state = AUTHENTICATED;
+                        terminal.lastReply = TerminalReply::SELECT_OPERATION;
+                        break;
+                    case AuthResult::WRONG_PIN:
+                        terminal.lastReply = TerminalReply::WRONG_PIN;
+                        break;
+                    case AuthResult::LOCKED:
+                    case AuthResult::UNKNOWN_CARD:
+                        terminal = TerminalState();
+                        terminal.lastReply = TerminalReply::CARD_RETAINED;
+                        break;
+                }
+                return;
+            case TerminalEvent::OPERATION_SELECTED: {
+                if (terminal.state != AUTHENTICATED) {
+                    terminal.lastReply = TerminalReply::OUT_OF_SEQUENCE;
+                    return;
+                }
+                TerminalReply reply = runOperation(terminal, message);
+                terminal = TerminalState(); // one transaction per session, then eject
+                terminal.lastReply = reply;
+                ++loop.sessionsCompleted;
+                return;
+            }
+        }
+    }
+
+    void run(EventLoop& loop) {
+        vector<TerminalMessage> batch;
+        unique_lock<mutex> guard(loop.lock);
+        while (true) {
+            loop.changed.wait(guard, [&] { return loop.stopping || !loop.inbox.empty(); });
+            if (loop.inbox.empty()) return;
+            batch.swap(loop.inbox);
+            guard.unlock();
+            for (const TerminalMessage& message : batch) handle(loop, message);
+            size_t done = batch.size();
+            batch.clear();
+            guard.lock();
+            loop.processed += done;
+            loop.changed.notify_all();
+        }
+    }
+
+public:
+    ATMSessionServer(Bank& bank, size_t terminalCount, unsigned loopCount) : bank(bank), terminals(terminalCount) {
+        for (unsigned i = 0; i < max(1u, loopCount); ++i) loops.push_back(make_unique<EventLoop>());
+        for (auto& loop : loops) loop->worker = thread(&ATMSessionServer::run, this, ref(*loop));
+    }
+
+    ~ATMSessionServer() {
+        for (auto& loop : loops) {
+            {
+                lock_guard<mutex> guard(loop->lock);
+                loop->stopping = true;
+            }
+            loop->changed.notify_all();
+            loop->worker.join();
+        }
+    }
+
+    // Called from any thread. Messages for one terminal are handled in the order
+    // a single sender submitted them. Unknown terminals are rejected here, before
+    // a loop thread could index past the terminal table.
+    void submit(const TerminalMessage& message) {
+        if (message.terminal >= terminals.size()) throw out_of_range("Unknown terminal");
+        EventLoop& loop = *loops[message.terminal % loops.size()];
+        {
+            lock_guard<mutex> guard(loop.lock);
+            loop.inbox.push_back(message);
+            ++loop.submitted;
+        }
+        loop.changed.notify_one();
+    }
+
+    void flush() {
+        for (auto& loop : loops) {
+            unique_lock<mutex> guard(loop->lock);
+            loop->changed.wait(guard, [&] { return loop->processed == loop->submitted; });
+        }
+    }
+
+    // Read after flush()
+    TerminalReply lastReply(uint32_t terminal) const {
+        return terminals.at(terminal).lastReply;
+    }
+
+    uint64_t sessionsCompleted() {
+        uint64_t total = 0;
+        for (auto& loop : loops) {
+            lock_guard<mutex> guard(loop->lock);
+            total += loop->sessionsCompleted;
+        }
+        return total;
+    }
+};
+
+TerminalMessage insertCard(uint32_t terminal, const Card* card) {
+    TerminalMessage message{};
+    message.terminal = terminal;
+    message.event = TerminalEvent::CARD_INSERTED;
+    message.card = card;
+    return message;
+}
+
+TerminalMessage enterPin(uint32_t terminal, const char* pin) {
+    TerminalMessage message{};
+    message.terminal = terminal;
+    message.event = TerminalEvent::PIN_ENTERED;
+    strncpy(message.pin, pin, sizeof(message.pin) - 1);
+    return message;
+}
+
+TerminalMessage selectOperation(uint32_t terminal, TerminalOperation operation, int64_t cents = 0,
+                                BankAccount* target = nullptr) {
+    TerminalMessage message{};
+    message.terminal = terminal;
+    message.event = TerminalEvent::OPERATION_SELECTED;
+    message.operation = operation;
+    message.amount = cents;
+    message.target = target;
+    return message;
+}
+
+// Terminals run back-to-back sessions (card, PIN, withdraw-or-deposit) as fast as
+// the server accepts them
+void runSessionServerBenchmark(int terminalCount, int sessionsPerTerminal, unsigned loops) {
+    Bank& bank = Bank::getInstance();
+    const int cardCount = 1000;
+    vector<unique_ptr<Card>> cards;
+    vector<unique_ptr<BankAccount>> accounts;
+    for (int i = 0; i < cardCount; ++i) {
+        string number = "9000-0000-0000-" + to_string(1000 + i);
+        cards.push_back(make_unique<Card>(number, "Load Test"));
+        accounts.push_back(make_unique<BankAccount>("LOAD" + to_string(i), 100000000));
+        bank.addAccount(accounts.back().get(), cards.back().get(), "4321");
+    }
+
+    ATMSessionServer server(bank, terminalCount, loops);
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < sessionsPerTerminal; ++round) {
+        for (int t = 0; t < terminalCount; ++t) {
+            server.submit(insertCard(t, cards[(t + round) % cardCount].get()));
+            server.submit(enterPin(t, "4321"));
+            server.submit(selectOperation(t, round % 2 ? TerminalOperation::DEPOSIT : TerminalOperation::WITHDRAW, 2000));
+        }
+    }
+    server.flush();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << terminalCount << " terminals on " << loops << " event loop(s): " << server.sessionsCompleted() / seconds
+         << " sessions/s (" << server.sessionsCompleted() << " sessions, " << sizeof(TerminalState)
+         << " bytes of state per terminal)" << endl;
+}
+
+// --- Journal benchmark: commit latency and throughput by group size ---
+void runJournalBenchmark(size_t maxBatch, size_t records, const string& path) {
+    remove(path.c_str());
+    TransactionLog log(path, maxBatch);
+    // One committing session per slot in a group, so groups can actually fill
+    size_t sessions = maxBatch;
+    size_t perSession = max<size_t>(1, records / sessions);
+    vector<vector<double>> latencies(sessions);
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (size_t t = 0; t < sessions; ++t) {
+        threads.emplace_back([&, t] {
+            latencies[t].reserve(perSession);
+            for (size_t i = 0; i < perSession; ++i) {
+                auto begin = chrono::steady_clock::now();
+                log.waitDurable(log.append(LogOp::DEPOSIT, "BENCH", "", 100));
+                latencies[t].push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count());
+            }
+        });
+    }
+    for (thread& th : threads) th.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    vector<double> all;
+    for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    sort(all.begin(), all.end());
+    cout << "Group size " << maxBatch << ": " << all.size() / seconds << " commits/s, latency p50 "
+         << all[all.size() / 2] << " us, p99 " << all[all.size() * 99 / 100] << " us (average group "
+         << log.averageGroupSize() << ")" << endl;
+    remove(path.c_str());
+}
+
+// --- Credential benchmark: lookup latency percentiles on a large table ---
+void runCredentialBenchmark(size_t cardCount, size_t lookups) {
+    CredentialStore store;
+    store.reserve(cardCount);
+    char number[32];
+    for (size_t i = 0; i < cardCount; ++i) {
+        snprintf(number, sizeof(number), "4000-%014zu", i);
+        store.enroll(number, to_string(1000 + i % 9000));
+    }
+
+    mt19937_64 rng(7);
+    vector<double> nanos;
+    nanos.reserve(lookups);
+    size_t accepted = 0;
+    for (size_t q = 0; q < lookups; ++q) {
+        size_t card = rng() % cardCount;
+        snprintf(number, sizeof(number), "4000-%014zu", card);
+        string cardNumber = number, pin = to_string(1000 + card % 9000);
+        auto start = chrono::steady_clock::now();
+        accepted += store.verify(cardNumber, pin) == AuthResult::OK;
+        nanos.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - start).count());
+    }
+    sort(nanos.begin(), nanos.end());
+    cout << store.size() << " cards in " << store.bytes() / (1024 * 1024) << " MB, longest probe "
+         << store.longestProbe() << " slots; verify p50 " << nanos[lookups / 2] << " ns, p99 "
+         << nanos[lookups * 99 / 100] << " ns, p99.9 " << nanos[lookups * 999 / 1000] << " ns (" << accepted
+         << "/" << lookups << " accepted)" << endl;
+}
+
+// --- Velocity benchmark: latency the check adds to each withdrawal ---
+void runVelocityBenchmark(size_t cardCount, size_t checks) {
+    VelocityGuard guard(VelocityRules{1000000, INT64_MAX / 2});
+    vector<string> cards(cardCount);
+    for (size_t i = 0; i < cardCount; ++i) cards[i] = "4000-" + to_string(100000000 + i);
+    mt19937_64 rng(99);
+    time_t now = 1700000000;
+    for (const string& card : cards) guard.checkWithdrawal(card, 2000, now); // warm the table
+
+    vector<double> nanos;
+    nanos.reserve(checks);
+    for (size_t q = 0; q < checks; ++q) {
+        const string& card = cards[rng() % cardCount];
+        now += rng() % 3; // time moves on, so bucket rotation is exercised
+        auto start = chrono::steady_clock::now();
+        guard.checkWithdrawal(card, 2000, now);
+        nanos.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - start).count());
+    }
+    sort(nanos.begin(), nanos.end());
+    cout << cardCount << " cards: velocity check p50 " << nanos[checks / 2] << " ns, p99 " << nanos[checks * 99 / 100]
+         << " ns, p99.9 " << nanos[checks * 999 / 1000] << " ns" << endl;
+}
+
+// --- Dispenser benchmark: cost of planning and incremental table updates ---
+void runDispenserBenchmark(size_t withdrawals) {
+    const uint32_t full[] = { 2000, 2000, 4000, 4000 };
+    CashDispenser dispenser({{10000, full[0]}, {5000, full[1]}, {2000, full[2]}, {1000, full[3]}}, 100000, 100);
+    mt19937 rng(5);
+    size_t refills = 0, notes = 0;
+    uint64_t rebuiltBefore = dispenser.getLayersRebuilt();
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < withdrawals; ++i) {
+        int64_t cents = (2 + rng() % 99) * 1000; // $20 to $1,000 in $10 steps
+        optional<vector<uint32_t>> plan = dispenser.plan(cents);
+        if (!plan) {
+            for (size_t c = 0; c < 4; ++c) dispenser.refill(c, full[c]);
+            ++refills;
+            plan = dispenser.plan(cents);
+        }
+        dispenser.commit(*plan);
+        for (uint32_t n : *plan) notes += n;
+    }
+    double nanos = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / withdrawals;
+    cout << withdrawals << " withdrawals: " << nanos << " ns each (plan + update), "
+         << static_cast<double>(notes) / withdrawals << " notes on average, "
+         << dispenser.getLayersRebuilt() - rebuiltBefore << " DP layers rebuilt, " << refills << " refills" << endl;
+}
+
+// --- Concurrency benchmark: many threads on a few hot accounts ---
+void runHotAccountBenchmark(int threadCount, int accountCount, int opsPerThread) {
+    const int64_t startingCents = 1000000; // $10,000 each
+    vector<unique_ptr<BankAccount>> accounts;
+    for (int i = 0; i < accountCount; ++i) {
+        char number[16];
+        snprintf(number, sizeof(number), "HOT%03d", i);
+        accounts.push_back(make_unique<BankAccount>(number, startingCents));
+    }
+
+    atomic<int64_t> deposited{0}, withdrawn{0};
+    atomic<long> transfers{0}, rejected{0};
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            mt19937 rng(t + 1);
+            int64_t myDeposits = 0, myWithdrawals = 0;
+            long myTransfers = 0, myRejected = 0;
+            for (int op = 0; op < opsPerThread; ++op) {
+                BankAccount& a = *accounts[rng() % accountCount];
+                BankAccount& b = *accounts[rng() % accountCount];
+                int64_t cents = 100 + rng() % 50000;
+                switch (rng() % 4) {
+                    case 0:
+                        if (a.deposit(cents)) myDeposits += cents;
+                        break;
+                    case 1:
+                        if (a.withdraw(cents)) myWithdrawals += cents; else ++myRejected;
+                        break;
+                    default:
+                        if (BankAccount::transfer(a, b, cents)) ++myTransfers; else ++myRejected;
+                        break;
+                }
+            }
+            deposited += myDeposits;
+            withdrawn += myWithdrawals;
+            transfers += myTransfers;
+            rejected += myRejected;
+        });
+    }
+    for (thread& th : threads) th.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    int64_t total = 0;
+    bool overdrawn = false;
+    for (auto& account : accounts) {
+        total += account->getBalance();
+        overdrawn |= account->getBalance() < 0;
+    }
+    int64_t expected = startingCents * accountCount + deposited - withdrawn;
+    cout << threadCount << " threads on " << accountCount << " hot accounts: "
+         << static_cast<double>(threadCount) * opsPerThread / seconds / 1e6 << " M ops/s (" << transfers
+         << " transfers, " << rejected << " rejected for funds)" << endl;
+    cout << "Money conserved: " << (total == expected ? "yes" : "NO") << ", any account overdrawn: "
+         << (overdrawn ? "YES" : "no") << " (total " << formatMoney(total) << ")" << endl;
+}
+
+
 // --- Main function to simulate the ATM usage ---
 int main() {
     // 1. Setup Bank and Accounts (this would be done by the bank admin)
     Bank& centralBank = Bank::getInstance();
     
     Card card1("1111-2222-3333-4444", "John Doe");
-    BankAccount account1("ACC001", 1500.00);
+    BankAccount account1("ACC001", toCents(1500.00));
     centralBank.addAccount(&account1, &card1, "1234");
 
     Card card2("5555-6666-7777-8888", "Jane Smith");
-    BankAccount account2("ACC002", 500.00);
+    BankAccount account2("ACC002", toCents(500.00));
     centralBank.addAccount(&account2, &card2, "9876");
 
+    Card clashingCard("9999-0000-1111-2222", "Clash Test");
+    BankAccount clashingAccount("ACC001", 0);
+    try {
+        centralBank.addAccount(&clashingAccount, &clashingCard, "0000");
+    } catch (const invalid_argument& e) {
+        cout << "Account rejected: " << e.what() << endl;
+    }
+
     // 2. Initialize the ATM
     ATM myATM;
 
@@ -280,5 +1853,128 @@ int main() {
     myATM.enterPin("9876"); // Correct PIN
     myATM.selectOperation(); // User will choose to check balance
 
+    cout << "\n--- WRITE-AHEAD JOURNAL ---" << endl;
+    remove("/tmp/atm.wal");
+    centralBank.attachJournal("/tmp/atm.wal", 16);
+    centralBank.deposit(account1, toCents(150.00));
+    centralBank.deposit(account1, toCents(50.00));
+    centralBank.checkpoint("/tmp/atm.checkpoint"); // trims the first deposit from the log
+    centralBank.transfer(account1, account2, toCents(75.50));
+    centralBank.withdraw(account2, toCents(20.00));
+    int64_t before1 = account1.getBalance(), before2 = account2.getBalance();
+    centralBank.detachJournal();
+    // Crash: in-memory balances are gone
+    account1.restoreBalance(0);
+    account2.restoreBalance(0);
+    size_t replayed = centralBank.recover("/tmp/atm.checkpoint", "/tmp/atm.wal");
+    cout << "Recovered from checkpoint + " << replayed << " journal records: " << formatMoney(account1.getBalance())
+         << " / " << formatMoney(account2.getBalance()) << " ("
+         << (account1.getBalance() == before1 && account2.getBalance() == before2 ? "matches" : "DIFFERS")
+         << " pre-crash balances)" << endl;
+    vector<LogRecord> kept = TransactionLog::readIntact("/tmp/atm.wal");
+    cout << "Log after checkpoint trim: " << kept.size() << " records from LSN " << kept.front().lsn << endl;
+    for (size_t batch : { 1, 16, 256 }) runJournalBenchmark(batch, 4096, "/tmp/atm_bench.wal");
+
+    cout << "\n--- END-OF-DAY SETTLEMENT ---" << endl;
+    runSettlementBenchmark(100000, 4000000, max(1u, thread::hardware_concurrency()));
+    runSettlementBenchmark(100000, 4000000, 4);
+
+    cout << "\n--- VELOCITY CHECKS ---" << endl;
+    centralBank.setVelocityRules(VelocityRules{3, toCents(300.00)});
+    cout << "Mistyped -$5.00: "
+         << (centralBank.authorizeWithdrawal("5555-6666-7777-8888", toCents(-5.00)) == FraudDecision::INVALID_AMOUNT
+             ? "rejected as invalid, not counted" : "COUNTED") << endl;
+    for (int i = 1; i <= 4; ++i) {
+        FraudDecision decision = centralBank.authorizeWithdrawal("5555-6666-7777-8888", toCents(80.00));
+        cout << "Withdrawal " << i << " of $80.00: "
+             << (decision == FraudDecision::ALLOW ? "allowed"
+                 : decision == FraudDecision::TOO_MANY_WITHDRAWALS ? "flagged (too many this hour)"
+                 : "flagged (daily amount)") << endl;
+    }
+    centralBank.setVelocityRules(VelocityRules{10, toCents(300.00)});
+    cout << "After raising the hourly limit, $80.00 more: "
+         << (centralBank.authorizeWithdrawal("5555-6666-7777-8888", toCents(80.00)) == FraudDecision::ALLOW
+             ? "allowed" : "flagged (daily amount)") << endl;
+    {
+        // One withdrawal an hour: a try that bounces for funds must not use it up
+        centralBank.setVelocityRules(VelocityRules{1, toCents(300.00)});
+        BankAccount savings("ACC900", 0);
+        WithdrawTransaction(toCents(50.00), nullptr, "4000-1111-2222-3333").execute(&savings);
+        savings.deposit(toCents(100.00));
+        WithdrawTransaction(toCents(50.00), nullptr, "4000-1111-2222-3333").execute(&savings);
+        centralBank.setVelocityRules(VelocityRules{10, toCents(300.00)});
+    }
+    runVelocityBenchmark(1000000, 1000000);
+
+    cout << "\n--- CASH DISPENSER ---" << endl;
+    {
+        // $60 is normally $50 + $10. With those two cassettes nearly empty, their notes
+        // cost almost double, so three $20s become the cheaper plan.
+        CashDispenser stocked({{10000, 200}, {5000, 200}, {2000, 1000}, {1000, 200}}, 100000, 100);
+        CashDispenser low({{10000, 200}, {5000, 2}, {2000, 1000}, {1000, 2}}, 100000, 100);
+        cout << "$60, well stocked: " << stocked.describe(*stocked.plan(6000)) << endl;
+        cout << "$60, $50 and $10 running low: " << low.describe(*low.plan(6000)) << endl;
+        // Scarce notes are still paid out when nothing else makes the amount, until they run out
+        CashDispenser tens({{10000, 200}, {5000, 200}, {2000, 3}, {1000, 2}}, 100000, 100);
+        for (int64_t dollars : { 80, 30, 30 }) {
+            optional<vector<uint32_t>> plan = tens.plan(dollars * 100);
+            cout << "$" << dollars << " with few $20 and $10 notes left: " << (plan ? tens.describe(*plan) : "cannot dispense") << endl;
+            if (plan) tens.commit(*plan);
+        }
+        try {
+            CashDispenser pennies({{1, 100}}, 10000000, 100);
+        } catch (const invalid_argument& e) {
+            cout << "$100,000 in 1-cent notes: " << e.what() << endl;
+        }
+    }
+    runDispenserBenchmark(1000000);
+
+    cout << "\n--- CREDENTIAL STORE ---" << endl;
+    for (const char* guess : { "1111", "2222", "3333", "9876" }) {
+        centralBank.authenticateUser("5555-6666-7777-8888", guess);
+    }
+    centralBank.unlockCard("5555-6666-7777-8888");
+    centralBank.authenticateUser("5555-6666-7777-8888", "9876");
+    {
+        // Eight terminals guess at once; together they still get only three tries
+        CredentialStore store;
+        store.enroll("4000-0000-0000-0001", "2468");
+        atomic<int> wrongPins{0};
+        vector<thread> guessers;
+        for (int t = 0; t < 8; ++t) {
+            guessers.emplace_back([&, t] {
+                for (int g = 0; g < 100; ++g) {
+                    wrongPins += store.verify("4000-0000-0000-0001", to_string(3000 + t * 100 + g)) == AuthResult::WRONG_PIN;
+                }
+            });
+        }
+        for (thread& t : guessers) t.join();
+        cout << "8 terminals guessing at once: " << wrongPins << " WRONG_PIN replies, then locked (at most 2 expected)" << endl;
+    }
+    runCredentialBenchmark(4000000, 1000000);
+
+    cout << "\n--- SESSION SERVER ---" << endl;
+    {
+        // Two terminals served by message instead of cin
+        ATMSessionServer server(centralBank, 2, 1);
+        server.submit(insertCard(0, &card1));
+        server.submit(insertCard(1, &card2));
+        server.submit(enterPin(0, "1234"));
+        server.submit(enterPin(1, "1111"));
+        server.submit(selectOperation(0, TerminalOperation::TRANSFER, toCents(25.00), &account2));
+        server.flush();
+        cout << "Terminal 0: " << describe(server.lastReply(0)) << ", terminal 1: " << describe(server.lastReply(1)) << endl;
+        cout << "Balances: " << formatMoney(account1.getBalance()) << " / " << formatMoney(account2.getBalance()) << endl;
+        try {
+            server.submit(insertCard(7, &card1));
+        } catch (const out_of_range& e) {
+            cout << "Message for terminal 7 rejected: " << e.what() << endl;
+        }
+    }
+    runSessionServerBenchmark(10000, 50, max(1u, thread::hardware_concurrency()));
+
+    cout << "\n--- HOT ACCOUNT CONTENTION ---" << endl;
+    runHotAccountBenchmark(64, 8, 20000);
+
     return 0;
 }
@@ -3,6 +3,24 @@
 #include <string>
 #include <stdexcept>
 #include <cmath>
+#include <cstdint>
+#include <cctype>
+#include <cstring>
+#include <sstream>
+#include <fstream>
+#include <chrono>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <algorithm>
 
 using namespace std;
 
@@ -14,23 +32,131 @@ class Board;
 enum class Color { WHITE, BLACK };
 enum class PieceType { KING, QUEEN, ROOK, BISHOP, KNIGHT, PAWN };
 
-// Represents a single square on the board
-class Spot {
+// Bitboards: bit (x * 8 + y) is set when square (x, y) is occupied
+typedef uint64_t Bitboard;
+
+inline int squareIndex(int x, int y) { return x * 8 + y; }
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+inline int lowestSquare(Bitboard b) { return __builtin_ctzll(b); }
+
+inline Color opponent(Color color) {
+    return color == Color::WHITE ? Color::BLACK : Color::WHITE;
+}
+
+// Algebraic names: file a-h is y, rank 1-8 is x + 1
+inline string squareName(int x, int y) {
+    return string(1, static_cast<char>('a' + y)) + static_cast<char>('1' + x);
+}
+
+// Uppercase FEN/SAN letter for a piece type
+inline char pieceLetter(PieceType type) {
+    static const char letters[6] = { 'K', 'Q', 'R', 'B', 'N', 'P' };
+    return letters[static_cast<int>(type)];
+}
+
+inline bool pieceTypeFromLetter(char letter, PieceType& type) {
+    switch (toupper(static_cast<unsigned char>(letter))) {
+        case 'K': type = PieceType::KING; return true;
+        case 'Q': type = PieceType::QUEEN; return true;
+        case 'R': type = PieceType::ROOK; return true;
+        case 'B': type = PieceType::BISHOP; return true;
+        case 'N': type = PieceType::KNIGHT; return true;
+        case 'P': type = PieceType::PAWN; return true;
+        default: return false;
+    }
+}
+
+// Material plus piece-square tables (simplified evaluation function).
+// Tables are written from White's side: the first row is rank x = 0.
+class PieceSquareTables {
 private:
-    int x, y;
-    Piece* piece;
+    static constexpr int PIECE_VALUES[6] = { 0, 900, 500, 330, 320, 100 };
 
-public:
-    Spot(int x, int y, Piece* piece) : x(x), y(y), piece(piece) {}
+    static constexpr int TABLES[6][64] = {
+        { // KING
+             20, 30, 10,  0,  0, 10, 30, 20,
+             20, 20,  0,  0,  0,  0, 20, 20,
+            -10,-20,-20,-20,-20,-20,-20,-10,
+            -20,-30,-30,-40,-40,-30,-30,-20,
+            -30,-40,-40,-50,-50,-40,-40,-30,
+            -30,-40,-40,-50,-50,-40,-40,-30,
+            -30,-40,-40,-50,-50,-40,-40,-30,
+            -30,-40,-40,-50,-50,-40,-40,-30 },
+        { // QUEEN
+            -20,-10,-10, -5, -5,-10,-10,-20,
+            -10,  0,  5,  0,  0,  0,  0,-10,
+            -10,  5,  5,  5,  5,  5,  0,-10,
+              0,  0,  5,  5,  5,  5,  0, -5,
+             -5,  0,  5,  5,  5,  5,  0, -5,
+            -10,  0,  5,  5,  5,  5,  0,-10,
+            -10,  0,  0,  0,  0,  0,  0,-10,
+            -20,-10,-10, -5, -5,-10,-10,-20 },
+        { // ROOK
+              0,  0,  0,  5,  5,  0,  0,  0,
+             -5,  0,  0,  0,  0,  0,  0, -5,
+             -5,  0,  0,  0,  0,  0,  0, -5,
+             -5,  0,  0,  0,  0,  0,  0, -5,
+             -5,  0,  0,  0,  0,  0,  0, -5,
+             -5,  0,  0,  0,  0,  0,  0, -5,
+              5, 10, 10, 10, 10, 10, 10,  5,
+              0,  0,  0,  0,  0,  0,  0,  0 },
+        { // BISHOP
+            -20,-10,-10,-10,-10,-10,-10,-20,
+            -10,  5,  0,  0,  0,  0,  5,-10,
+            -10, 10, 10, 10, 10, 10, 10,-10,
+            -10,  0, 10, 10, 10, 10,  0,-10,
+            -10,  5,  5, 10, 10,  5,  5,-10,
+            -10,  0,  5, 10, 10,  5,  0,-10,
+            -10,  0,  0,  0,  0,  0,  0,-10,
+            -20,-10,-10,-10,-10,-10,-10,-20 },
+        { // KNIGHT
+            -50,-40,-30,-30,-30,-30,-40,-50,
+            -40,-20,  0,  5,  5,  0,-20,-40,
+            -30,  5, 10, 15, 15, 10,  5,-30,
+            -30,  0, 15, 20, 20, 15,  0,-30,
+            -30,  5, 15, 20, 20, 15,  5,-30,
+            -30,  0, 10, 15, 15, 10,  0,-30,
+            -40,-20,  0,  0,  0,  0,-20,-40,
+            -50,-40,-30,-30,-30,-30,-40,-50 },
+        { // PAWN
+              0,  0,  0,  0,  0,  0,  0,  0,
+              5, 10, 10,-20,-20, 10, 10,  5,
+              5, -5,-10,  0,  0,-10, -5,  5,
+              0,  0,  0, 20, 20,  0,  0,  0,
+              5,  5, 10, 25, 25, 10,  5,  5,
+             10, 10, 20, 30, 30, 20, 10, 10,
+             50, 50, 50, 50, 50, 50, 50, 50,
+              0,  0,  0,  0,  0,  0,  0,  0 }
+    };
 
-    Piece* getPiece() const {
-        return piece;
+public:
+    // Score of a piece on a square from White's point of view (positive favours White)
+    static int value(PieceType type, Color color, int x, int y) {
+        int t = static_cast<int>(type);
+        if (color == Color::WHITE) {
+            return PIECE_VALUES[t] + TABLES[t][squareIndex(x, y)];
+        }
+        return -(PIECE_VALUES[t] + TABLES[t][squareIndex(7 - x, y)]);
     }
+};
 
-    void setPiece(Piece* p) {
-        piece = p;
+// Represents a single square on the board. Stored compactly (3 bytes): the piece is
+// kept as a code into the shared flyweight pieces rather than as an owned pointer.
+class Spot {
+private:
+    int8_t x, y;
+    uint8_t pieceCode; // 0 when empty
+
+public:
+    Spot() : x(0), y(0), pieceCode(0) {}
+    Spot(int x, int y, Piece* piece) : x(static_cast<int8_t>(x)), y(static_cast<int8_t>(y)), pieceCode(0) {
+        setPiece(piece);
     }
 
+    Piece* getPiece() const; // Implementation after Piece is defined
+
+    void setPiece(Piece* p);
+
     int getX() const {
         return x;
     }
@@ -40,32 +166,170 @@ public:
     }
 };
 
+// Random keys for Zobrist hashing, laid out like Polyglot's table (12 x 64 pieces,
+// 4 castling rights, 8 en passant files, side to move) and generated from a fixed seed
+class Zobrist {
+private:
+    uint64_t keys[781];
+
+    Zobrist() {
+        uint64_t state = 0x2545F4914F6CDD1DULL;
+        for (uint64_t& key : keys) {
+            // splitmix64
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key = z ^ (z >> 31);
+        }
+    }
+
+    static const Zobrist& get() {
+        static Zobrist table;
+        return table;
+    }
+
+public:
+    static uint64_t piece(PieceType type, Color color, int sq) {
+        return get().keys[(static_cast<int>(color) * 6 + static_cast<int>(type)) * 64 + sq];
+    }
+    static uint64_t castling(int rightIndex) { return get().keys[768 + rightIndex]; }
+    static uint64_t enPassantFile(int y) { return get().keys[772 + y]; }
+    static uint64_t whiteToMove() { return get().keys[780]; }
+};
+
+// Everything needed to take a move back, so a search can make/unmake instead of copying boards
+struct MoveRecord {
+    int startX, startY, endX, endY;
+    Piece* captured;
+    int capturedX, capturedY;   // differs from the end square only for en passant
+    Piece* promotedPawn;        // pawn taken off the board by a promotion, else nullptr
+    int rookStartY, rookEndY;   // -1 unless the move was castling
+    int previousCastlingRights;
+    int previousEnPassant;
+    int previousHalfmoveClock;
+};
+
+// Castling right bits
+enum CastlingRight { WHITE_KINGSIDE = 1, WHITE_QUEENSIDE = 2, BLACK_KINGSIDE = 4, BLACK_QUEENSIDE = 8 };
+
 // Represents the 8x8 game board
 class Board {
 private:
-    vector<vector<Spot*>> boxes;
+    Spot boxes[8][8];
+
+    // Kept in sync with boxes on every move so evaluation never has to rescan the board
+    Bitboard pieceBB[2][6];
+    Bitboard colorBB[2];
+    int psqtScore; // material + piece-square score, White minus Black
+    uint64_t pieceKey; // Zobrist hash of piece placement only
+
+    // Position state beyond piece placement (needed for FEN and the special moves)
+    int castlingRights;
+    int enPassantSquare; // square a pawn just skipped over, or -1
+    int halfmoveClock;
+    int fullmoveNumber;
+
+    void addPiece(Piece* piece, int x, int y);
+    void removePiece(Piece* piece, int x, int y);
+    void rebuildIncrementalState();
+    void clearBoard();
+    static int castlingRightsTouchedBy(int x, int y);
 
 public:
-    Board() {
-        boxes.resize(8, vector<Spot*>(8, nullptr));
+    static constexpr const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    Board() : pieceBB(), colorBB(), psqtScore(0), pieceKey(0), castlingRights(0), enPassantSquare(-1),
+              halfmoveClock(0), fullmoveNumber(1) {
+        for (int i = 0; i < 8; ++i) {
+            for (int j = 0; j < 8; ++j) {
+                boxes[i][j] = Spot(i, j, nullptr);
+            }
+        }
         resetBoard();
     }
 
-    Spot* getBox(int x, int y) const {
+    Spot* getBox(int x, int y) {
+        if (x < 0 || x >= 8 || y < 0 || y >= 8) {
+            throw out_of_range("Index out of bounds");
+        }
+        return &boxes[x][y];
+    }
+
+    const Spot* getBox(int x, int y) const {
         if (x < 0 || x >= 8 || y < 0 || y >= 8) {
             throw out_of_range("Index out of bounds");
         }
-        return boxes[x][y];
+        return &boxes[x][y];
+    }
+
+    Bitboard getPieces(Color color, PieceType type) const {
+        return pieceBB[static_cast<int>(color)][static_cast<int>(type)];
+    }
+
+    Bitboard getPieces(Color color) const {
+        return colorBB[static_cast<int>(color)];
+    }
+
+    Bitboard getOccupancy() const {
+        return colorBB[0] | colorBB[1];
+    }
+
+    int getPsqtScore() const {
+        return psqtScore;
+    }
+
+    int getEnPassantSquare() const {
+        return enPassantSquare;
+    }
+
+    bool hasCastlingRight(Color color, bool kingSide) const {
+        int right = (color == Color::WHITE) ? (kingSide ? WHITE_KINGSIDE : WHITE_QUEENSIDE)
+                                            : (kingSide ? BLACK_KINGSIDE : BLACK_QUEENSIDE);
+        return (castlingRights & right) != 0;
+    }
+
+    // True when every square strictly between two squares on a line or diagonal is empty
+    bool isPathClear(int startX, int startY, int endX, int endY) const {
+        int stepX = (endX > startX) - (endX < startX);
+        int stepY = (endY > startY) - (endY < startY);
+        for (int x = startX + stepX, y = startY + stepY; x != endX || y != endY; x += stepX, y += stepY) {
+            if (boxes[x][y].getPiece() != nullptr) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isSquareAttacked(int x, int y, Color byColor) const;
+    bool isInCheck(Color color) const;
+
+    // Full position hash: placement, castling rights, en passant file and side to move
+    uint64_t getZobristKey(Color sideToMove) const {
+        uint64_t key = pieceKey;
+        for (int i = 0; i < 4; ++i) {
+            if (castlingRights & (1 << i)) key ^= Zobrist::castling(i);
+        }
+        if (enPassantSquare >= 0) key ^= Zobrist::enPassantFile(enPassantSquare % 8);
+        if (sideToMove == Color::WHITE) key ^= Zobrist::whiteToMove();
+        return key;
     }
 
     void resetBoard(); // Implementation after Piece is defined
+
+    // FEN import/export; loadFen throws invalid_argument and returns the side to move
+    Color loadFen(const string& fen);
+    string toFen(Color sideToMove) const;
+
+    // Moves without any rule checks; handles castling, en passant and promotion
+    MoveRecord makeMove(int startX, int startY, int endX, int endY, PieceType promotion = PieceType::QUEEN);
+    void unmakeMove(const MoveRecord& record);
 };
 
 // Abstract base class for all pieces
 class Piece {
 protected:
     Color color;
-    PieceType type;
+    PieceType type = PieceType::PAWN;
 
 public:
     Piece(Color color, PieceType type) : color(color), type(type) {}
@@ -84,6 +348,18 @@ public:
     
     // Static Factory Method
     static Piece* createPiece(PieceType type, Color color);
+
+    // Pieces carry no per-game state, so all boards share one instance per
+    // (type, color) - Flyweight Pattern. Code 0 stands for an empty square.
+    static Piece* get(PieceType type, Color color) {
+        return fromCode(static_cast<uint8_t>(1 + static_cast<int>(color) * 6 + static_cast<int>(type)));
+    }
+
+    static Piece* fromCode(uint8_t code);
+
+    uint8_t getCode() const {
+        return static_cast<uint8_t>(1 + static_cast<int>(color) * 6 + static_cast<int>(type));
+    }
 };
 
 
@@ -92,11 +368,23 @@ class Pawn : public Piece {
 public:
     Pawn(Color color) : Piece(color, PieceType::PAWN) {}
     bool canMove(const Board& board, const Spot& start, const Spot& end) const override {
-        // Basic pawn move: one step forward
-        // Does not include initial two-step move, en passant, or capturing diagonally
         int forward = (getColor() == Color::WHITE) ? 1 : -1;
-        if (start.getX() + forward == end.getX() && start.getY() == end.getY() && end.getPiece() == nullptr) {
-            return true;
+        int startRank = (getColor() == Color::WHITE) ? 1 : 6;
+        int dx = end.getX() - start.getX();
+        int dy = end.getY() - start.getY();
+
+        // Pushes: one step, or two from the starting rank, onto empty squares
+        if (dy == 0 && end.getPiece() == nullptr) {
+            if (dx == forward) {
+                return true;
+            }
+            return dx == 2 * forward && start.getX() == startRank
+                && board.getBox(start.getX() + forward, start.getY())->getPiece() == nullptr;
+        }
+
+        // Captures: one step diagonally onto a piece or the en passant square
+        if (dx == forward && abs(dy) == 1) {
+            return end.getPiece() != nullptr || squareIndex(end.getX(), end.getY()) == board.getEnPassantSquare();
         }
         return false;
     }
@@ -120,8 +408,7 @@ public:
         if (abs(start.getX() - end.getX()) != abs(start.getY() - end.getY())) {
             return false;
         }
-        // Simplified: doesn't check for pieces in the way
-        return true;
+        return board.isPathClear(start.getX(), start.getY(), end.getX(), end.getY());
     }
 };
 
@@ -133,8 +420,7 @@ public:
         if (start.getX() != end.getX() && start.getY() != end.getY()) {
             return false;
         }
-        // Simplified: doesn't check for pieces in the way
-        return true;
+        return board.isPathClear(start.getX(), start.getY(), end.getX(), end.getY());
     }
 };
 
@@ -148,8 +434,7 @@ public:
         if (!isStraight && !isDiagonal) {
             return false;
         }
-        // Simplified: doesn't check for pieces in the way
-        return true;
+        return board.isPathClear(start.getX(), start.getY(), end.getX(), end.getY());
     }
 };
 
@@ -159,7 +444,31 @@ public:
     bool canMove(const Board& board, const Spot& start, const Spot& end) const override {
         int dx = abs(start.getX() - end.getX());
         int dy = abs(start.getY() - end.getY());
-        return dx <= 1 && dy <= 1;
+        if (dx <= 1 && dy <= 1) {
+            return true;
+        }
+
+        // Castling: two files along the home rank, with the right intact, the rook in
+        // its corner, nothing in between, and the king not passing through check
+        int home = (getColor() == Color::WHITE) ? 0 : 7;
+        if (start.getX() != home || start.getY() != 4 || end.getX() != home || dy != 2) {
+            return false;
+        }
+        bool kingSide = end.getY() == 6;
+        int rookY = kingSide ? 7 : 0;
+        Piece* rook = board.getBox(home, rookY)->getPiece();
+        if (!board.hasCastlingRight(getColor(), kingSide) || rook == nullptr
+            || rook->getType() != PieceType::ROOK || rook->getColor() != getColor()
+            || !board.isPathClear(home, 4, home, rookY)) {
+            return false;
+        }
+        int step = kingSide ? 1 : -1;
+        for (int y = 4; y != end.getY() + step; y += step) {
+            if (board.isSquareAttacked(home, y, opponent(getColor()))) {
+                return false;
+            }
+        }
+        return true;
     }
 };
 
@@ -176,51 +485,474 @@ Piece* Piece::createPiece(PieceType type, Color color) {
     }
 }
 
+Piece* Piece::fromCode(uint8_t code) {
+    static const vector<Piece*> pieces = [] {
+        vector<Piece*> all(13, nullptr);
+        for (int c = 0; c < 2; ++c) {
+            for (int t = 0; t < 6; ++t) {
+                all[1 + c * 6 + t] = createPiece(static_cast<PieceType>(t), static_cast<Color>(c));
+            }
+        }
+        return all;
+    }();
+    return pieces[code];
+}
+
+Piece* Spot::getPiece() const {
+    return Piece::fromCode(pieceCode);
+}
+
+void Spot::setPiece(Piece* p) {
+    pieceCode = (p != nullptr) ? p->getCode() : 0;
+}
+
+void Board::clearBoard() {
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            boxes[i][j].setPiece(nullptr);
+        }
+    }
+}
+
 void Board::resetBoard() {
-    // Clear existing pieces if any (important for re-game)
+    loadFen(START_FEN);
+}
+
+Color Board::loadFen(const string& fen) {
+    istringstream in(fen);
+    string placement, side, castling = "-", enPassant = "-";
+    int halfmove = 0, fullmove = 1;
+    in >> placement >> side >> castling >> enPassant >> halfmove >> fullmove;
+
+    // Validate everything before touching the current position
+    char grid[8][8] = {};
+    int x = 7, y = 0;
+    PieceType type = PieceType::PAWN;
+    for (char c : placement) {
+        if (c == '/') {
+            if (y != 8 || x == 0) throw invalid_argument("Bad FEN placement: " + fen);
+            --x;
+            y = 0;
+        } else if (c >= '1' && c <= '8') {
+            y += c - '0';
+        } else if (y < 8 && pieceTypeFromLetter(c, type)) {
+            grid[x][y++] = c;
+        } else {
+            throw invalid_argument("Bad FEN placement: " + fen);
+        }
+        if (y > 8) throw invalid_argument("Bad FEN placement: " + fen);
+    }
+    if (x != 0 || y != 8) throw invalid_argument("Bad FEN placement: " + fen);
+    if (side != "w" && side != "b") throw invalid_argument("Bad FEN side to move: " + fen);
+
+    int rights = 0;
+    for (char c : castling) {
+        switch (c) {
+            case 'K': rights |= WHITE_KINGSIDE; break;
+            case 'Q': rights |= WHITE_QUEENSIDE; break;
+            case 'k': rights |= BLACK_KINGSIDE; break;
+            case 'q': rights |= BLACK_QUEENSIDE; break;
+            case '-': break;
+            default: throw invalid_argument("Bad FEN castling rights: " + fen);
+        }
+    }
+
+    int epSquare = -1;
+    if (enPassant != "-") {
+        if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h' || enPassant[1] < '1' || enPassant[1] > '8') {
+            throw invalid_argument("Bad FEN en passant square: " + fen);
+        }
+        epSquare = squareIndex(enPassant[1] - '1', enPassant[0] - 'a');
+    }
+
+    clearBoard();
     for (int i = 0; i < 8; ++i) {
         for (int j = 0; j < 8; ++j) {
-            if (boxes[i][j] != nullptr && boxes[i][j]->getPiece() != nullptr) {
-                delete boxes[i][j]->getPiece();
-            }
-            delete boxes[i][j];
-        }
-    }
-
-    // White pieces
-    boxes[0][0] = new Spot(0, 0, Piece::createPiece(PieceType::ROOK, Color::WHITE));
-    boxes[0][1] = new Spot(0, 1, Piece::createPiece(PieceType::KNIGHT, Color::WHITE));
-    boxes[0][2] = new Spot(0, 2, Piece::createPiece(PieceType::BISHOP, Color::WHITE));
-    boxes[0][3] = new Spot(0, 3, Piece::createPiece(PieceType::QUEEN, Color::WHITE));
-    boxes[0][4] = new Spot(0, 4, Piece::createPiece(PieceType::KING, Color::WHITE));
-    boxes[0][5] = new Spot(0, 5, Piece::createPiece(PieceType::BISHOP, Color::WHITE));
-    boxes[0][6] = new Spot(0, 6, Piece::createPiece(PieceType::KNIGHT, Color::WHITE));
-    boxes[0][7] = new Spot(0, 7, Piece::createPiece(PieceType::ROOK, Color::WHITE));
-    for (int j = 0; j < 8; ++j) {
-        boxes[1][j] = new Spot(1, j, Piece::createPiece(PieceType::PAWN, Color::WHITE));
-    }
-
-    // Black pieces
-    boxes[7][0] = new Spot(7, 0, Piece::createPiece(PieceType::ROOK, Color::BLACK));
-    boxes[7][1] = new Spot(7, 1, Piece::createPiece(PieceType::KNIGHT, Color::BLACK));
-    boxes[7][2] = new Spot(7, 2, Piece::createPiece(PieceType::BISHOP, Color::BLACK));
-    boxes[7][3] = new Spot(7, 3, Piece::createPiece(PieceType::QUEEN, Color::BLACK));
-    boxes[7][4] = new Spot(7, 4, Piece::createPiece(PieceType::KING, Color::BLACK));
-    boxes[7][5] = new Spot(7, 5, Piece::createPiece(PieceType::BISHOP, Color::BLACK));
-    boxes[7][6] = new Spot(7, 6, Piece::createPiece(PieceType::KNIGHT, Color::BLACK));
-    boxes[7][7] = new Spot(7, 7, Piece::createPiece(PieceType::ROOK, Color::BLACK));
-    for (int j = 0; j < 8; ++j) {
-        boxes[6][j] = new Spot(6, j, Piece::createPiece(PieceType::PAWN, Color::BLACK));
+            Piece* piece = nullptr;
+            if (grid[i][j] != 0) {
+                pieceTypeFromLetter(grid[i][j], type);
+                piece = Piece::get(type, isupper(static_cast<unsigned char>(grid[i][j])) ? Color::WHITE : Color::BLACK);
+            }
+            boxes[i][j].setPiece(piece);
+        }
     }
-    
-    // Empty spots
-    for(int i = 2; i < 6; ++i) {
-        for(int j = 0; j < 8; ++j) {
-            boxes[i][j] = new Spot(i, j, nullptr);
+    castlingRights = rights;
+    enPassantSquare = epSquare;
+    halfmoveClock = halfmove;
+    fullmoveNumber = fullmove > 0 ? fullmove : 1;
+    rebuildIncrementalState();
+
+    return side == "w" ? Color::WHITE : Color::BLACK;
+}
+
+string Board::toFen(Color sideToMove) const {
+    string fen;
+    for (int x = 7; x >= 0; --x) {
+        int empty = 0;
+        for (int y = 0; y < 8; ++y) {
+            Piece* piece = boxes[x][y].getPiece();
+            if (piece == nullptr) {
+                ++empty;
+                continue;
+            }
+            if (empty > 0) {
+                fen += static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            char letter = pieceLetter(piece->getType());
+            fen += piece->getColor() == Color::WHITE ? letter : static_cast<char>(tolower(letter));
+        }
+        if (empty > 0) fen += static_cast<char>('0' + empty);
+        if (x > 0) fen += '/';
+    }
+
+    fen += sideToMove == Color::WHITE ? " w " : " b ";
+    if (castlingRights == 0) fen += '-';
+    if (castlingRights & WHITE_KINGSIDE) fen += 'K';
+    if (castlingRights & WHITE_QUEENSIDE) fen += 'Q';
+    if (castlingRights & BLACK_KINGSIDE) fen += 'k';
+    if (castlingRights & BLACK_QUEENSIDE) fen += 'q';
+    fen += ' ';
+    fen += enPassantSquare < 0 ? string("-") : squareName(enPassantSquare / 8, enPassantSquare % 8);
+    fen += ' ' + to_string(halfmoveClock) + ' ' + to_string(fullmoveNumber);
+    return fen;
+}
+
+void Board::addPiece(Piece* piece, int x, int y) {
+    Bitboard bit = 1ULL << squareIndex(x, y);
+    int c = static_cast<int>(piece->getColor());
+    pieceBB[c][static_cast<int>(piece->getType())] |= bit;
+    colorBB[c] |= bit;
+    psqtScore += PieceSquareTables::value(piece->getType(), piece->getColor(), x, y);
+    pieceKey ^= Zobrist::piece(piece->getType(), piece->getColor(), squareIndex(x, y));
+}
+
+void Board::removePiece(Piece* piece, int x, int y) {
+    Bitboard bit = 1ULL << squareIndex(x, y);
+    int c = static_cast<int>(piece->getColor());
+    pieceBB[c][static_cast<int>(piece->getType())] &= ~bit;
+    colorBB[c] &= ~bit;
+    psqtScore -= PieceSquareTables::value(piece->getType(), piece->getColor(), x, y);
+    pieceKey ^= Zobrist::piece(piece->getType(), piece->getColor(), squareIndex(x, y));
+}
+
+void Board::rebuildIncrementalState() {
+    for (int c = 0; c < 2; ++c) {
+        colorBB[c] = 0;
+        for (int t = 0; t < 6; ++t) {
+            pieceBB[c][t] = 0;
+        }
+    }
+    psqtScore = 0;
+    pieceKey = 0;
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            if (boxes[i][j].getPiece() != nullptr) {
+                addPiece(boxes[i][j].getPiece(), i, j);
+            }
+        }
+    }
+}
+
+int Board::castlingRightsTouchedBy(int x, int y) {
+    if (x == 0 && y == 4) return WHITE_KINGSIDE | WHITE_QUEENSIDE;
+    if (x == 0 && y == 7) return WHITE_KINGSIDE;
+    if (x == 0 && y == 0) return WHITE_QUEENSIDE;
+    if (x == 7 && y == 4) return BLACK_KINGSIDE | BLACK_QUEENSIDE;
+    if (x == 7 && y == 7) return BLACK_KINGSIDE;
+    if (x == 7 && y == 0) return BLACK_QUEENSIDE;
+    return 0;
+}
+
+MoveRecord Board::makeMove(int startX, int startY, int endX, int endY, PieceType promotion) {
+    Spot* startBox = getBox(startX, startY);
+    Spot* endBox = getBox(endX, endY);
+    Piece* moving = startBox->getPiece();
+    MoveRecord record = {startX, startY, endX, endY, endBox->getPiece(), endX, endY, nullptr, -1, -1,
+                         castlingRights, enPassantSquare, halfmoveClock};
+    bool isPawn = moving->getType() == PieceType::PAWN;
+
+    // En passant: a pawn moving diagonally onto an empty square takes the pawn beside it
+    if (isPawn && startY != endY && record.captured == nullptr) {
+        record.capturedX = startX;
+        record.captured = boxes[startX][endY].getPiece();
+        boxes[startX][endY].setPiece(nullptr);
+    }
+    if (record.captured != nullptr) {
+        removePiece(record.captured, record.capturedX, record.capturedY);
+    }
+
+    removePiece(moving, startX, startY);
+    startBox->setPiece(nullptr);
+    Piece* placed = moving;
+    if (isPawn && (endX == 0 || endX == 7)) {
+        record.promotedPawn = moving;
+        placed = Piece::get(promotion, moving->getColor());
+    }
+    addPiece(placed, endX, endY);
+    endBox->setPiece(placed);
+
+    // Castling: the king has moved two files, so bring the rook across
+    if (moving->getType() == PieceType::KING && abs(endY - startY) == 2) {
+        record.rookStartY = endY > startY ? 7 : 0;
+        record.rookEndY = endY > startY ? 5 : 3;
+        Piece* rook = boxes[startX][record.rookStartY].getPiece();
+        removePiece(rook, startX, record.rookStartY);
+        addPiece(rook, startX, record.rookEndY);
+        boxes[startX][record.rookStartY].setPiece(nullptr);
+        boxes[startX][record.rookEndY].setPiece(rook);
+    }
+
+    enPassantSquare = (isPawn && abs(endX - startX) == 2) ? squareIndex((startX + endX) / 2, startY) : -1;
+    castlingRights &= ~(castlingRightsTouchedBy(startX, startY) | castlingRightsTouchedBy(endX, endY));
+    halfmoveClock = (isPawn || record.captured != nullptr) ? 0 : halfmoveClock + 1;
+    if (moving->getColor() == Color::BLACK) {
+        ++fullmoveNumber;
+    }
+    return record;
+}
+
+void Board::unmakeMove(const MoveRecord& record) {
+    Spot* startBox = getBox(record.startX, record.startY);
+    Spot* endBox = getBox(record.endX, record.endY);
+    Piece* placed = endBox->getPiece();
+
+    if (record.rookStartY >= 0) {
+        Piece* rook = boxes[record.startX][record.rookEndY].getPiece();
+        removePiece(rook, record.startX, record.rookEndY);
+        addPiece(rook, record.startX, record.rookStartY);
+        boxes[record.startX][record.rookEndY].setPiece(nullptr);
+        boxes[record.startX][record.rookStartY].setPiece(rook);
+    }
+
+    removePiece(placed, record.endX, record.endY);
+    endBox->setPiece(nullptr);
+    Piece* moving = placed;
+    if (record.promotedPawn != nullptr) {
+        moving = record.promotedPawn;
+    }
+    addPiece(moving, record.startX, record.startY);
+    startBox->setPiece(moving);
+
+    if (record.captured != nullptr) {
+        addPiece(record.captured, record.capturedX, record.capturedY);
+        boxes[record.capturedX][record.capturedY].setPiece(record.captured);
+    }
+
+    castlingRights = record.previousCastlingRights;
+    enPassantSquare = record.previousEnPassant;
+    halfmoveClock = record.previousHalfmoveClock;
+    if (moving->getColor() == Color::BLACK) {
+        --fullmoveNumber;
+    }
+}
+
+// Precomputed attack sets; sliding pieces walk rays against the occupancy bitboard
+class AttackTables {
+private:
+    Bitboard knight[64];
+    Bitboard king[64];
+    Bitboard pawn[2][64];
+
+    AttackTables() {
+        const int knightSteps[8][2] = {{1,2},{2,1},{2,-1},{1,-2},{-1,-2},{-2,-1},{-2,1},{-1,2}};
+        const int kingSteps[8][2] = {{1,0},{1,1},{0,1},{-1,1},{-1,0},{-1,-1},{0,-1},{1,-1}};
+        for (int x = 0; x < 8; ++x) {
+            for (int y = 0; y < 8; ++y) {
+                int sq = squareIndex(x, y);
+                knight[sq] = steps(x, y, knightSteps);
+                king[sq] = steps(x, y, kingSteps);
+                pawn[0][sq] = pawn[1][sq] = 0;
+                for (int dy = -1; dy <= 1; dy += 2) {
+                    if (y + dy < 0 || y + dy > 7) continue;
+                    if (x < 7) pawn[0][sq] |= 1ULL << squareIndex(x + 1, y + dy);
+                    if (x > 0) pawn[1][sq] |= 1ULL << squareIndex(x - 1, y + dy);
+                }
+            }
+        }
+    }
+
+    static Bitboard steps(int x, int y, const int (&deltas)[8][2]) {
+        Bitboard result = 0;
+        for (const auto& d : deltas) {
+            int nx = x + d[0], ny = y + d[1];
+            if (nx >= 0 && nx < 8 && ny >= 0 && ny < 8) {
+                result |= 1ULL << squareIndex(nx, ny);
+            }
         }
+        return result;
+    }
+
+    static Bitboard rays(int sq, Bitboard occupancy, const int (&deltas)[4][2]) {
+        Bitboard result = 0;
+        for (const auto& d : deltas) {
+            int nx = sq / 8 + d[0], ny = sq % 8 + d[1];
+            while (nx >= 0 && nx < 8 && ny >= 0 && ny < 8) {
+                Bitboard bit = 1ULL << squareIndex(nx, ny);
+                result |= bit;
+                if (occupancy & bit) break;
+                nx += d[0];
+                ny += d[1];
+            }
+        }
+        return result;
+    }
+
+    static const AttackTables& get() {
+        static AttackTables tables;
+        return tables;
+    }
+
+public:
+    static Bitboard knightAttacks(int sq) { return get().knight[sq]; }
+    static Bitboard kingAttacks(int sq) { return get().king[sq]; }
+    static Bitboard pawnAttacks(Color color, int sq) { return get().pawn[static_cast<int>(color)][sq]; }
+
+    static Bitboard bishopAttacks(int sq, Bitboard occupancy) {
+        static const int diagonals[4][2] = {{1,1},{1,-1},{-1,1},{-1,-1}};
+        return rays(sq, occupancy, diagonals);
+    }
+
+    static Bitboard rookAttacks(int sq, Bitboard occupancy) {
+        static const int lines[4][2] = {{1,0},{-1,0},{0,1},{0,-1}};
+        return rays(sq, occupancy, lines);
+    }
+};
+
+bool Board::isSquareAttacked(int x, int y, Color byColor) const {
+    int sq = squareIndex(x, y);
+    Bitboard occupancy = getOccupancy();
+    Bitboard queens = getPieces(byColor, PieceType::QUEEN);
+    return (AttackTables::pawnAttacks(opponent(byColor), sq) & getPieces(byColor, PieceType::PAWN))
+        || (AttackTables::knightAttacks(sq) & getPieces(byColor, PieceType::KNIGHT))
+        || (AttackTables::kingAttacks(sq) & getPieces(byColor, PieceType::KING))
+        || (AttackTables::bishopAttacks(sq, occupancy) & (getPieces(byColor, PieceType::BISHOP) | queens))
+        || (AttackTables::rookAttacks(sq, occupancy) & (getPieces(byColor, PieceType::ROOK) | queens));
+}
+
+bool Board::isInCheck(Color color) const {
+    Bitboard king = getPieces(color, PieceType::KING);
+    if (king == 0) {
+        return false;
     }
+    int sq = lowestSquare(king);
+    return isSquareAttacked(sq / 8, sq % 8, opponent(color));
 }
 
+// Fixed-size cache of pawn-structure scores. Pawns move rarely, so most probes hit.
+class PawnHashTable {
+private:
+    struct Entry {
+        Bitboard whitePawns;
+        Bitboard blackPawns;
+        int score;
+    };
+    vector<Entry> entries;
+
+    static uint64_t hashPawns(Bitboard white, Bitboard black) {
+        uint64_t h = white * 0x9E3779B97F4A7C15ULL ^ (black + 0x632BE59BD9B4E019ULL) * 0xC2B2AE3D27D4EB4FULL;
+        return h ^ (h >> 29);
+    }
+
+public:
+    PawnHashTable(size_t sizePowerOfTwo = 1 << 14) : entries(sizePowerOfTwo, Entry{~0ULL, ~0ULL, 0}) {}
+
+    bool probe(Bitboard white, Bitboard black, int& score) const {
+        const Entry& e = entries[hashPawns(white, black) & (entries.size() - 1)];
+        if (e.whitePawns == white && e.blackPawns == black) {
+            score = e.score;
+            return true;
+        }
+        return false;
+    }
+
+    void store(Bitboard white, Bitboard black, int score) {
+        entries[hashPawns(white, black) & (entries.size() - 1)] = {white, black, score};
+    }
+};
+
+// Static evaluation: incremental material/PST from the board, plus mobility and
+// pawn structure computed with bitboard popcounts
+class Evaluator {
+private:
+    static constexpr int MOBILITY_WEIGHT = 4;
+    static constexpr int DOUBLED_PAWN_PENALTY = 15;
+    static constexpr int ISOLATED_PAWN_PENALTY = 12;
+    static constexpr int PASSED_PAWN_BONUS[8] = { 0, 10, 15, 25, 40, 60, 90, 0 };
+
+    PawnHashTable pawnTable;
+
+    static Bitboard fileMask(int y) { return 0x0101010101010101ULL << y; }
+
+    static Bitboard adjacentFiles(int y) {
+        return (y > 0 ? fileMask(y - 1) : 0) | (y < 7 ? fileMask(y + 1) : 0);
+    }
+
+    // Squares in front of a pawn on its own and adjacent files
+    static Bitboard frontSpan(Color color, int x, int y) {
+        Bitboard files = fileMask(y) | adjacentFiles(y);
+        Bitboard ranks = (color == Color::WHITE)
+            ? (x == 7 ? 0 : ~0ULL << (8 * (x + 1)))
+            : (x == 0 ? 0 : ~0ULL >> (8 * (8 - x)));
+        return files & ranks;
+    }
+
+    static int pawnScore(Color color, Bitboard own, Bitboard enemy) {
+        int score = 0;
+        for (int y = 0; y < 8; ++y) {
+            int onFile = popCount(own & fileMask(y));
+            if (onFile > 1) score -= (onFile - 1) * DOUBLED_PAWN_PENALTY;
+            if (onFile > 0 && (own & adjacentFiles(y)) == 0) score -= onFile * ISOLATED_PAWN_PENALTY;
+        }
+        for (Bitboard b = own; b; b &= b - 1) {
+            int sq = lowestSquare(b);
+            int x = sq / 8, y = sq % 8;
+            if ((enemy & frontSpan(color, x, y)) == 0) {
+                score += PASSED_PAWN_BONUS[color == Color::WHITE ? x : 7 - x];
+            }
+        }
+        return score;
+    }
+
+    static int mobility(const Board& board, Color color) {
+        Bitboard occupancy = board.getOccupancy();
+        Bitboard targets = ~board.getPieces(color);
+        int moves = 0;
+        for (Bitboard b = board.getPieces(color, PieceType::KNIGHT); b; b &= b - 1) {
+            moves += popCount(AttackTables::knightAttacks(lowestSquare(b)) & targets);
+        }
+        Bitboard diagonal = board.getPieces(color, PieceType::BISHOP) | board.getPieces(color, PieceType::QUEEN);
+        for (Bitboard b = diagonal; b; b &= b - 1) {
+            moves += popCount(AttackTables::bishopAttacks(lowestSquare(b), occupancy) & targets);
+        }
+        Bitboard straight = board.getPieces(color, PieceType::ROOK) | board.getPieces(color, PieceType::QUEEN);
+        for (Bitboard b = straight; b; b &= b - 1) {
+            moves += popCount(AttackTables::rookAttacks(lowestSquare(b), occupancy) & targets);
+        }
+        return moves;
+    }
+
+public:
+    int pawnStructure(const Board& board) {
+        Bitboard white = board.getPieces(Color::WHITE, PieceType::PAWN);
+        Bitboard black = board.getPieces(Color::BLACK, PieceType::PAWN);
+        int score;
+        if (!pawnTable.probe(white, black, score)) {
+            score = pawnScore(Color::WHITE, white, black) - pawnScore(Color::BLACK, black, white);
+            pawnTable.store(white, black, score);
+        }
+        return score;
+    }
+
+    // Centipawns from the point of view of the side to move
+    int evaluate(const Board& board, Color sideToMove) {
+        int score = board.getPsqtScore()
+                  + MOBILITY_WEIGHT * (mobility(board, Color::WHITE) - mobility(board, Color::BLACK))
+                  + pawnStructure(board);
+        return sideToMove == Color::WHITE ? score : -score;
+    }
+};
+
 class Player {
 private:
     Color color;
@@ -229,7 +961,11 @@ public:
     Color getColor() const { return color; }
 };
 
-// Main Game Controller - Singleton Pattern
+// Outcome of validating a move, so callers can decide whether to print anything
+enum class MoveStatus { OK, NO_PIECE, NOT_YOUR_TURN, OWN_PIECE, INVALID_FOR_PIECE, LEAVES_KING_IN_CHECK, NO_GAME };
+
+// Main Game Controller - one instance per match. Holds only position state
+// (a few hundred bytes), so a server can keep many thousands of games in memory.
 class Game {
 private:
     Board board;
@@ -237,72 +973,917 @@ private:
     Player player2;
     Player* currentPlayer;
 
-    // Private constructor for Singleton
+public:
     Game() : board(), player1(Color::WHITE), player2(Color::BLACK), currentPlayer(&player1) {}
-    
-    // Prevent copying
+
+    // Prevent copying (currentPlayer points into this object)
     Game(const Game&) = delete;
     Game& operator=(const Game&) = delete;
 
-public:
-    // Static method to get the single instance
-    static Game& getInstance() {
-        static Game instance; // Guaranteed to be created only once
-        return instance;
-    }
-    
     Board& getBoard() {
         return board;
     }
 
-    bool makeMove(int startX, int startY, int endX, int endY) {
+    Color getCurrentColor() const {
+        return currentPlayer->getColor();
+    }
+
+    void reset() {
+        board.resetBoard();
+        currentPlayer = &player1;
+    }
+
+    void loadFen(const string& fen) {
+        Color sideToMove = board.loadFen(fen);
+        currentPlayer = (sideToMove == Color::WHITE) ? &player1 : &player2;
+    }
+
+    string toFen() const {
+        return board.toFen(currentPlayer->getColor());
+    }
+
+    uint64_t getZobristKey() const {
+        return board.getZobristKey(currentPlayer->getColor());
+    }
+
+    // Full rule check without changing the position
+    MoveStatus validateMove(int startX, int startY, int endX, int endY, PieceType promotion = PieceType::QUEEN) {
         Spot* startBox = board.getBox(startX, startY);
         Spot* endBox = board.getBox(endX, endY);
         Piece* sourcePiece = startBox->getPiece();
 
         // 1. Basic validation
         if (sourcePiece == nullptr) {
-            cout << "No piece at starting position." << endl;
-            return false;
+            return MoveStatus::NO_PIECE;
         }
 
         if (sourcePiece->getColor() != currentPlayer->getColor()) {
-            cout << "Not your turn." << endl;
-            return false;
+            return MoveStatus::NOT_YOUR_TURN;
         }
 
         // 2. Check if the destination has a piece of the same color
         if (endBox->getPiece() != nullptr && endBox->getPiece()->getColor() == currentPlayer->getColor()) {
-            cout << "Cannot capture your own piece." << endl;
-            return false;
+            return MoveStatus::OWN_PIECE;
         }
 
         // 3. Use the piece's own logic (Strategy Pattern) to validate the move
         if (!sourcePiece->canMove(board, *startBox, *endBox)) {
-            cout << "Invalid move for this piece." << endl;
-            return false;
+            return MoveStatus::INVALID_FOR_PIECE;
         }
 
-        // 4. Make the move
-        Piece* destPiece = endBox->getPiece();
-        endBox->setPiece(sourcePiece);
-        startBox->setPiece(nullptr);
-
-        // Delete captured piece
-        if (destPiece != nullptr) {
-            delete destPiece;
+        // A pawn may only promote to a queen, rook, bishop or knight
+        if (promotion != PieceType::QUEEN && promotion != PieceType::ROOK && promotion != PieceType::BISHOP
+            && promotion != PieceType::KNIGHT) {
+            return MoveStatus::INVALID_FOR_PIECE;
         }
 
-        // 5. Change turn
-        currentPlayer = (currentPlayer == &player1) ? &player2 : &player1;
-        
-        cout << "Move successful." << endl;
+        // 4. Try it and take it back: the mover's king must not be left attacked
+        MoveRecord record = board.makeMove(startX, startY, endX, endY, promotion);
+        bool inCheck = board.isInCheck(currentPlayer->getColor());
+        board.unmakeMove(record);
+        return inCheck ? MoveStatus::LEAVES_KING_IN_CHECK : MoveStatus::OK;
+    }
+
+    // Validates and plays a move silently
+    MoveStatus tryMove(int startX, int startY, int endX, int endY, PieceType promotion = PieceType::QUEEN) {
+        MoveStatus status = validateMove(startX, startY, endX, endY, promotion);
+        if (status != MoveStatus::OK) {
+            return status;
+        }
+
+        board.makeMove(startX, startY, endX, endY, promotion);
+
+        // Change turn
+        currentPlayer = (currentPlayer == &player1) ? &player2 : &player1;
+        return MoveStatus::OK;
+    }
+
+    bool makeMove(int startX, int startY, int endX, int endY, PieceType promotion = PieceType::QUEEN) {
+        switch (tryMove(startX, startY, endX, endY, promotion)) {
+            case MoveStatus::OK: cout << "Move successful." << endl; return true;
+            case MoveStatus::NO_PIECE: cout << "No piece at starting position." << endl; break;
+            case MoveStatus::NOT_YOUR_TURN: cout << "Not your turn." << endl; break;
+            case MoveStatus::OWN_PIECE: cout << "Cannot capture your own piece." << endl; break;
+            case MoveStatus::INVALID_FOR_PIECE: cout << "Invalid move for this piece." << endl; break;
+            case MoveStatus::LEAVES_KING_IN_CHECK: cout << "Move leaves your king in check." << endl; break;
+            case MoveStatus::NO_GAME: cout << "No such game." << endl; break;
+        }
+        return false;
+    }
+};
+
+// Read-only memory map of a whole file (POSIX)
+class MappedFile {
+private:
+    const char* data;
+    size_t size;
+
+public:
+    explicit MappedFile(const string& path) : data(nullptr), size(0) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw runtime_error("Cannot stat " + path);
+        }
+        size = static_cast<size_t>(info.st_size);
+        if (size > 0) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw runtime_error("Cannot map " + path);
+            }
+            data = static_cast<const char*>(mapped);
+        }
+        close(fd); // the mapping stays valid after the descriptor is closed
+    }
+
+    ~MappedFile() {
+        if (data != nullptr) {
+            munmap(const_cast<char*>(data), size);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + size; }
+    size_t length() const { return size; }
+
+    void adviseSequential() const {
+        if (data != nullptr) {
+            madvise(const_cast<char*>(data), size, MADV_SEQUENTIAL);
+        }
+    }
+};
+
+// A move in Standard Algebraic Notation, parsed in place from the PGN buffer
+struct SanMove {
+    PieceType piece;
+    int fromX, fromY; // -1 when not given for disambiguation
+    int toX, toY;
+    PieceType promotion;
+};
+
+struct ReplayStats {
+    long games = 0;
+    long failedGames = 0;
+    long moves = 0;
+    double seconds = 0;
+
+    double gamesPerSecond() const {
+        return seconds > 0 ? games / seconds : 0;
+    }
+};
+
+// Streams games out of a memory-mapped PGN file and replays every move through
+// Game's validator. Tokens are parsed straight from the mapping and pieces are
+// shared flyweights, so no memory is allocated per move.
+class PgnReplayer {
+private:
+    Game& game;
+    ReplayStats stats;
+    bool inGame = false;
+    bool gameFailed = false;
+
+    static bool isDelimiter(char c) {
+        return isspace(static_cast<unsigned char>(c)) || c == '{' || c == '}' || c == '(' || c == ')'
+            || c == '[' || c == ']' || c == ';';
+    }
+
+    static bool isResult(const char* begin, const char* end) {
+        size_t n = end - begin;
+        return (n == 1 && *begin == '*')
+            || (n == 3 && (memcmp(begin, "1-0", 3) == 0 || memcmp(begin, "0-1", 3) == 0))
+            || (n == 7 && memcmp(begin, "1/2-1/2", 7) == 0);
+    }
+
+    bool parseSan(const char* begin, const char* end, SanMove& move) const {
+        move = {PieceType::PAWN, -1, -1, -1, -1, PieceType::QUEEN};
+        while (end > begin && (end[-1] == '+' || end[-1] == '#' || end[-1] == '!' || end[-1] == '?')) {
+            --end;
+        }
+
+        // Castling is written as a king move of two files
+        if (end - begin >= 3 && (begin[0] == 'O' || begin[0] == '0')) {
+            int home = game.getCurrentColor() == Color::WHITE ? 0 : 7;
+            move.piece = PieceType::KING;
+            move.fromX = move.toX = home;
+            move.fromY = 4;
+            move.toY = (end - begin >= 5) ? 2 : 6;
+            return true;
+        }
+
+        // Promotion suffix: "e8=Q" or "e8Q"
+        if (end - begin >= 3 && pieceTypeFromLetter(end[-1], move.promotion) && isupper(static_cast<unsigned char>(end[-1]))
+            && (end[-2] == '=' || isdigit(static_cast<unsigned char>(end[-2])))) {
+            end -= (end[-2] == '=') ? 2 : 1;
+        }
+
+        if (end - begin < 2) {
+            return false;
+        }
+        char file = end[-2], rank = end[-1];
+        if (file < 'a' || file > 'h' || rank < '1' || rank > '8') {
+            return false;
+        }
+        move.toX = rank - '1';
+        move.toY = file - 'a';
+        end -= 2;
+
+        if (begin < end && isupper(static_cast<unsigned char>(*begin))) {
+            if (!pieceTypeFromLetter(*begin, move.piece)) {
+                return false;
+            }
+            ++begin;
+        }
+        for (; begin < end; ++begin) {
+            if (*begin >= 'a' && *begin <= 'h') move.fromY = *begin - 'a';
+            else if (*begin >= '1' && *begin <= '8') move.fromX = *begin - '1';
+            else if (*begin != 'x' && *begin != '-') return false;
+        }
         return true;
     }
+
+    // Exactly one piece of the named type must be able to make the move legally
+    bool playSan(const char* begin, const char* end) {
+        SanMove move;
+        if (!parseSan(begin, end, move)) {
+            return false;
+        }
+        int fromX = -1, fromY = -1, found = 0;
+        for (Bitboard b = game.getBoard().getPieces(game.getCurrentColor(), move.piece); b; b &= b - 1) {
+            int sq = lowestSquare(b);
+            int x = sq / 8, y = sq % 8;
+            if ((move.fromX >= 0 && x != move.fromX) || (move.fromY >= 0 && y != move.fromY)) {
+                continue;
+            }
+            if (game.validateMove(x, y, move.toX, move.toY, move.promotion) == MoveStatus::OK) {
+                fromX = x;
+                fromY = y;
+                ++found;
+            }
+        }
+        return found == 1 && game.tryMove(fromX, fromY, move.toX, move.toY, move.promotion) == MoveStatus::OK;
+    }
+
+    void finishGame() {
+        if (inGame) {
+            if (gameFailed) ++stats.failedGames;
+            else ++stats.games;
+        }
+        inGame = false;
+        gameFailed = false;
+    }
+
+    // Skips from an opening bracket past its matching close (variations may nest)
+    static const char* skipBlock(const char* p, const char* end, char open, char closeChar) {
+        int depth = 0;
+        for (; p < end; ++p) {
+            if (*p == open) ++depth;
+            else if (*p == closeChar && --depth == 0) return p + 1;
+        }
+        return end;
+    }
+
+public:
+    explicit PgnReplayer(Game& game) : game(game) {}
+
+    ReplayStats replayFile(const string& path) {
+        MappedFile file(path);
+        file.adviseSequential();
+        stats = ReplayStats();
+        auto startTime = chrono::steady_clock::now();
+
+        const char* p = file.begin();
+        const char* end = file.end();
+        while (p < end) {
+            char c = *p;
+            if (isspace(static_cast<unsigned char>(c))) {
+                ++p;
+            } else if (c == '[') {
+                finishGame(); // tag pairs start the next game
+                while (p < end && *p != '\n') ++p;
+            } else if (c == ';') {
+                while (p < end && *p != '\n') ++p;
+            } else if (c == '{') {
+                p = skipBlock(p, end, '{', '}');
+            } else if (c == '(') {
+                p = skipBlock(p, end, '(', ')');
+            } else if (c == '$' || isDelimiter(c)) {
+                ++p;
+                while (p < end && !isDelimiter(*p)) ++p;
+            } else {
+                const char* tokenEnd = p;
+                while (tokenEnd < end && !isDelimiter(*tokenEnd)) ++tokenEnd;
+
+                if (isResult(p, tokenEnd)) {
+                    finishGame();
+                } else {
+                    // Move numbers ("12." or "12...") may be glued to the move itself
+                    const char* q = p;
+                    while (q < tokenEnd && isdigit(static_cast<unsigned char>(*q))) ++q;
+                    if (q < tokenEnd && *q == '.') {
+                        while (q < tokenEnd && *q == '.') ++q;
+                    } else {
+                        q = p;
+                    }
+                    if (q < tokenEnd) {
+                        if (!inGame) {
+                            game.reset();
+                            inGame = true;
+                        }
+                        if (!gameFailed) {
+                            if (playSan(q, tokenEnd)) ++stats.moves;
+                            else gameFailed = true;
+                        }
+                    }
+                }
+                p = tokenEnd;
+            }
+        }
+        finishGame();
+
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        return stats;
+    }
+};
+
+// A move as the engine hands it out, with where it came from
+struct EngineMove {
+    // CHECKMATE and STALEMATE mean the side to move has no legal move; the coordinates stay -1
+    enum class Source { NONE, BOOK, TABLEBASE, SEARCH, CHECKMATE, STALEMATE };
+    int startX = -1, startY = -1, endX = -1, endY = -1;
+    PieceType promotion = PieceType::QUEEN;
+    Source source = Source::NONE;
+    int score = 0;
 };
 
+// Polyglot move encoding: to file (bits 0-2), to rank (3-5), from file (6-8),
+// from rank (9-11), promotion piece (12-14: none, knight, bishop, rook, queen)
+inline uint16_t encodeBookMove(int startX, int startY, int endX, int endY, PieceType promotion = PieceType::PAWN) {
+    int promo = 0;
+    switch (promotion) {
+        case PieceType::KNIGHT: promo = 1; break;
+        case PieceType::BISHOP: promo = 2; break;
+        case PieceType::ROOK: promo = 3; break;
+        case PieceType::QUEEN: promo = 4; break;
+        default: break;
+    }
+    return static_cast<uint16_t>(endY | (endX << 3) | (startY << 6) | (startX << 9) | (promo << 12));
+}
+
+inline EngineMove decodeBookMove(uint16_t encoded, const Board& board) {
+    static const PieceType promotions[5] = { PieceType::QUEEN, PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN };
+    EngineMove move;
+    move.endY = encoded & 7;
+    move.endX = (encoded >> 3) & 7;
+    move.startY = (encoded >> 6) & 7;
+    move.startX = (encoded >> 9) & 7;
+    move.promotion = promotions[min((encoded >> 12) & 7, 4)];
+
+    // Polyglot writes castling as "king takes own rook" (e1h1); our king moves two files
+    Piece* piece = board.getBox(move.startX, move.startY)->getPiece();
+    if (piece != nullptr && piece->getType() == PieceType::KING && move.startY == 4 && move.startX == move.endX
+        && (move.endY == 7 || move.endY == 0)) {
+        move.endY = move.endY == 7 ? 6 : 2;
+    }
+    return move;
+}
+
+inline uint64_t readBigEndian(const unsigned char* p, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+inline void writeBigEndian(ostream& out, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// Polyglot-style opening book: 16-byte big-endian entries (key, move, weight, learn)
+// sorted by Zobrist key, binary searched straight out of the mapping. Opening costs
+// one mmap; pages are only faulted in along the search path.
+class OpeningBook {
+private:
+    static constexpr size_t ENTRY_SIZE = 16;
+    MappedFile file;
+
+    const unsigned char* entry(size_t index) const {
+        return reinterpret_cast<const unsigned char*>(file.begin()) + index * ENTRY_SIZE;
+    }
+
+public:
+    struct Entry {
+        uint64_t key;
+        uint16_t move;
+        uint16_t weight;
+    };
+
+    explicit OpeningBook(const string& path) : file(path) {}
+
+    size_t size() const {
+        return file.length() / ENTRY_SIZE;
+    }
+
+    // Highest-weighted book move for the position, if any
+    bool probe(uint64_t key, uint16_t& move) const {
+        size_t low = 0, high = size();
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            if (readBigEndian(entry(mid), 8) < key) low = mid + 1;
+            else high = mid;
+        }
+        uint16_t bestWeight = 0;
+        bool found = false;
+        for (size_t i = low; i < size() && readBigEndian(entry(i), 8) == key; ++i) {
+            uint16_t weight = static_cast<uint16_t>(readBigEndian(entry(i) + 10, 2));
+            if (!found || weight > bestWeight) {
+                move = static_cast<uint16_t>(readBigEndian(entry(i) + 8, 2));
+                bestWeight = weight;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    // Offline tool: sorts entries and writes them in book format
+    static void write(const string& path, vector<Entry> entries) {
+        sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+        ofstream out(path, ios::binary);
+        for (const Entry& e : entries) {
+            writeBigEndian(out, e.key, 8);
+            writeBigEndian(out, e.move, 2);
+            writeBigEndian(out, e.weight, 2);
+            writeBigEndian(out, 0, 4); // learn field, unused
+        }
+    }
+};
+
+// Endgame tablebase: sorted 16-byte native-endian records keyed by Zobrist hash,
+// holding the result for the side to move, distance to mate and the best move.
+// Only positions with few enough pieces are probed, so larger ones skip the lookup.
+class EndgameTablebase {
+public:
+    struct Entry {
+        uint64_t key;
+        int8_t wdl;        // +1 win, 0 draw, -1 loss for the side to move
+        uint8_t reserved;
+        uint16_t pliesToMate;
+        uint16_t bestMove; // book move encoding, 0 if none
+        uint16_t padding;
+    };
+    static_assert(sizeof(Entry) == 16, "tablebase records are 16 bytes");
+
+private:
+    MappedFile file;
+    int maxPieces;
+
+    const Entry* records() const {
+        return reinterpret_cast<const Entry*>(file.begin());
+    }
+
+public:
+    EndgameTablebase(const string& path, int maxPieces) : file(path), maxPieces(maxPieces) {}
+
+    int getMaxPieces() const {
+        return maxPieces;
+    }
+
+    bool probe(const Board& board, uint64_t key, Entry& result) const {
+        if (popCount(board.getOccupancy()) > maxPieces) {
+            return false;
+        }
+        const Entry* first = records();
+        const Entry* last = first + file.length() / sizeof(Entry);
+        const Entry* it = lower_bound(first, last, key, [](const Entry& e, uint64_t k) { return e.key < k; });
+        if (it == last || it->key != key) {
+            return false;
+        }
+        result = *it;
+        return true;
+    }
+
+    // Offline tool: sorts records and writes them in tablebase format
+    static void write(const string& path, vector<Entry> entries) {
+        sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+        ofstream out(path, ios::binary);
+        out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+    }
+};
+
+// Picks a move: opening book first, then the tablebase, and only then an alpha-beta
+// search (negamax over make/unmake, scored by the incremental Evaluator)
+class Engine {
+private:
+    static constexpr int MATE_SCORE = 100000;
+
+    const OpeningBook* book;
+    const EndgameTablebase* tablebase;
+    Evaluator evaluator;
+
+    struct Candidate {
+        int startX, startY, endX, endY;
+    };
+
+    // Candidate targets come from attack tables; each is confirmed by the piece's canMove
+    static void generateMoves(const Board& board, Color side, vector<Candidate>& moves) {
+        Bitboard own = board.getPieces(side);
+        Bitboard occupancy = board.getOccupancy();
+        for (Bitboard pieces = own; pieces; pieces &= pieces - 1) {
+            int sq = lowestSquare(pieces);
+            int x = sq / 8, y = sq % 8;
+            const Spot* start = board.getBox(x, y);
+            Piece* piece = start->getPiece();
+            Bitboard targets = 0;
+            switch (piece->getType()) {
+                case PieceType::KNIGHT: targets = AttackTables::knightAttacks(sq); break;
+                case PieceType::BISHOP: targets = AttackTables::bishopAttacks(sq, occupancy); break;
+                case PieceType::ROOK: targets = AttackTables::rookAttacks(sq, occupancy); break;
+                case PieceType::QUEEN: targets = AttackTables::bishopAttacks(sq, occupancy) | AttackTables::rookAttacks(sq, occupancy); break;
+                case PieceType::KING:
+                    targets = AttackTables::kingAttacks(sq);
+                    if (y == 4) {
+                        targets |= (1ULL << squareIndex(x, 2)) | (1ULL << squareIndex(x, 6));
+                    }
+                    break;
+                case PieceType::PAWN: {
+                    int forward = side == Color::WHITE ? 1 : -1;
+                    targets = AttackTables::pawnAttacks(side, sq);
+                    if (x + forward >= 0 && x + forward < 8) targets |= 1ULL << squareIndex(x + forward, y);
+                    if (x + 2 * forward >= 0 && x + 2 * forward < 8) targets |= 1ULL << squareIndex(x + 2 * forward, y);
+                    break;
+                }
+            }
+            for (Bitboard t = targets & ~own; t; t &= t - 1) {
+                int to = lowestSquare(t);
+                if (piece->canMove(board, *start, *board.getBox(to / 8, to % 8))) {
+                    moves.push_back({x, y, to / 8, to % 8});
+                }
+            }
+        }
+    }
+
+    int negamax(Board& board, Color side, int depth, int ply, int alpha, int beta) {
+        EndgameTablebase::Entry known;
+        if (ply > 0 && tablebase != nullptr && tablebase->probe(board, board.getZobristKey(side), known)) {
+            return known.wdl == 0 ? 0 : known.wdl * (MATE_SCORE - ply - known.pliesToMate);
+        }
+        if (depth == 0) {
+            return evaluator.evaluate(board, side);
+        }
+
+        vector<Candidate> moves;
+        generateMoves(board, side, moves);
+        bool anyLegal = false;
+        for (const Candidate& m : moves) {
+            MoveRecord record = board.makeMove(m.startX, m.startY, m.endX, m.endY);
+            if (board.isInCheck(side)) {
+                board.unmakeMove(record);
+                continue;
+            }
+            anyLegal = true;
+            int score = -negamax(board, opponent(side), depth - 1, ply + 1, -beta, -alpha);
+            board.unmakeMove(record);
+            if (score >= beta) {
+                return beta;
+            }
+            alpha = max(alpha, score);
+        }
+        if (!anyLegal) {
+            return board.isInCheck(side) ? -(MATE_SCORE - ply) : 0; // checkmate or stalemate
+        }
+        return alpha;
+    }
+
+public:
+    Engine(const OpeningBook* book, const EndgameTablebase* tablebase) : book(book), tablebase(tablebase) {}
+
+    EngineMove chooseMove(Game& game, int searchDepth) {
+        Board& board = game.getBoard();
+        Color side = game.getCurrentColor();
+        uint64_t key = game.getZobristKey();
+        EngineMove result;
+
+        uint16_t bookMove = 0;
+        if (book != nullptr && book->probe(key, bookMove)) {
+            result = decodeBookMove(bookMove, board);
+            if (game.validateMove(result.startX, result.startY, result.endX, result.endY, result.promotion) == MoveStatus::OK) {
+                result.source = EngineMove::Source::BOOK;
+                return result;
+            }
+        }
+
+        EndgameTablebase::Entry known;
+        if (tablebase != nullptr && tablebase->probe(board, key, known) && known.bestMove != 0) {
+            result = decodeBookMove(known.bestMove, board);
+            if (game.validateMove(result.startX, result.startY, result.endX, result.endY, result.promotion) == MoveStatus::OK) {
+                result.source = EngineMove::Source::TABLEBASE;
+                result.score = known.wdl == 0 ? 0 : known.wdl * (MATE_SCORE - known.pliesToMate);
+                return result;
+            }
+        }
+
+        searchDepth = max(searchDepth, 1); // negamax only stops when depth reaches 0
+        vector<Candidate> moves;
+        generateMoves(board, side, moves);
+        int alpha = -MATE_SCORE - 1;
+        for (const Candidate& m : moves) {
+            MoveRecord record = board.makeMove(m.startX, m.startY, m.endX, m.endY);
+            if (board.isInCheck(side)) {
+                board.unmakeMove(record);
+                continue;
+            }
+            int score = -negamax(board, opponent(side), searchDepth - 1, 1, -MATE_SCORE - 1, -alpha);
+            board.unmakeMove(record);
+            if (score > alpha) {
+                alpha = score;
+                result = EngineMove();
+                result.startX = m.startX;
+                result.startY = m.startY;
+                result.endX = m.endX;
+                result.endY = m.endY;
+                result.source = EngineMove::Source::SEARCH;
+                result.score = score;
+            }
+        }
+        if (result.source == EngineMove::Source::NONE) {
+            bool mated = board.isInCheck(side);
+            result.source = mated ? EngineMove::Source::CHECKMATE : EngineMove::Source::STALEMATE;
+            result.score = mated ? -MATE_SCORE : 0;
+        }
+        return result;
+    }
+};
+
+// Low 32 bits: slot * shardCount + shard. High 32 bits: the slot's generation, bumped
+// each time a game in the slot is closed, so an id is never handed out twice.
+using GameId = uint64_t;
+
+inline uint32_t gameSlotIndex(GameId id) { return static_cast<uint32_t>(id); }
+inline uint32_t gameGeneration(GameId id) { return static_cast<uint32_t>(id >> 32); }
+
+// A client's move (or lifecycle command) addressed to one hosted game
+struct GameRequest {
+    enum class Kind : uint8_t { CREATE, MOVE, CLOSE };
+    Kind kind;
+    uint8_t startX, startY, endX, endY;
+    PieceType promotion;
+    GameId gameId;
+};
+
+// Called on the shard thread with the outcome of every MOVE request
+using MoveReplyHandler = function<void(const GameRequest&, MoveStatus)>;
+
+// Owns a slice of the games and the only thread that touches them, so games
+// need no locks. The inbox is swapped out in batches by the shard's event loop.
+class GameShard {
+private:
+    deque<Game> games; // deque: growing never moves existing games
+    vector<bool> live; // live[slot]: created and not yet closed
+    vector<uint32_t> liveGeneration; // generation of the game now in each slot
+    vector<uint32_t> freeSlots; // guarded by inboxMutex, like slotGenerations
+    vector<uint32_t> slotGenerations; // generation the next game in each slot gets
+
+    mutex inboxMutex;
+    condition_variable inboxReady, batchHandled;
+    vector<GameRequest> inbox;
+    uint64_t posted = 0, handled = 0;
+    bool stopping = false;
+    thread worker;
+
+    const MoveReplyHandler& onReply;
+    atomic<long> movesApplied{0};
+    atomic<long> movesRejected{0};
+
+    // True if the id names the game currently in its slot, not an earlier or later one
+    bool isLive(uint32_t slot, GameId id) const {
+        return slot < games.size() && live[slot] && liveGeneration[slot] == gameGeneration(id);
+    }
+
+    void handle(const GameRequest& request, uint32_t slot) {
+        switch (request.kind) {
+            case GameRequest::Kind::CREATE:
+                while (games.size() <= slot) {
+                    games.emplace_back();
+                    live.push_back(false);
+                    liveGeneration.push_back(0);
+                }
+                games[slot].reset();
+                live[slot] = true;
+                liveGeneration[slot] = gameGeneration(request.gameId);
+                break;
+            case GameRequest::Kind::MOVE: {
+                // Unknown, closed or recycled game ids are answered, never played on a stranger's board
+                MoveStatus status = isLive(slot, request.gameId)
+                    ? games[slot].tryMove(request.startX, request.startY, request.endX, request.endY, request.promotion)
+                    : MoveStatus::NO_GAME;
+                if (status == MoveStatus::OK) ++movesApplied;
+                else ++movesRejected;
+                if (onReply) onReply(request, status);
+                break;
+            }
+            case GameRequest::Kind::CLOSE: {
+                if (!isLive(slot, request.gameId)) break; // closing twice must not free the slot twice
+                live[slot] = false;
+                lock_guard<mutex> lock(inboxMutex);
+                ++slotGenerations[slot];
+                freeSlots.push_back(slot);
+                break;
+            }
+        }
+    }
+
+    void run(uint32_t shardCount) {
+        vector<GameRequest> batch;
+        while (true) {
+            {
+                unique_lock<mutex> lock(inboxMutex);
+                inboxReady.wait(lock, [this] { return stopping || !inbox.empty(); });
+                if (inbox.empty()) {
+                    return; // stopping and fully drained
+                }
+                batch.swap(inbox);
+            }
+            for (const GameRequest& request : batch) {
+                handle(request, gameSlotIndex(request.gameId) / shardCount);
+            }
+            {
+                lock_guard<mutex> lock(inboxMutex);
+                handled += batch.size();
+            }
+            batchHandled.notify_all();
+            batch.clear();
+        }
+    }
+
+public:
+    GameShard(uint32_t shardCount, const MoveReplyHandler& onReply) : onReply(onReply) {
+        worker = thread(&GameShard::run, this, shardCount);
+    }
+
+    ~GameShard() {
+        stop();
+    }
+
+    // Reserves a slot for a new game and returns (slot, generation); CREATE must then be posted for it
+    pair<uint32_t, uint32_t> allocateSlot() {
+        lock_guard<mutex> lock(inboxMutex);
+        if (!freeSlots.empty()) {
+            uint32_t slot = freeSlots.back();
+            freeSlots.pop_back();
+            return {slot, slotGenerations[slot]};
+        }
+        slotGenerations.push_back(0);
+        return {static_cast<uint32_t>(slotGenerations.size() - 1), 0};
+    }
+
+    void post(const GameRequest& request) {
+        {
+            lock_guard<mutex> lock(inboxMutex);
+            inbox.push_back(request);
+            ++posted;
+        }
+        inboxReady.notify_one();
+    }
+
+    // Blocks until every request posted so far has been handled
+    void flush() {
+        unique_lock<mutex> lock(inboxMutex);
+        batchHandled.wait(lock, [this] { return handled == posted; });
+    }
+
+    // Processes everything already posted, then joins the event loop
+    void stop() {
+        {
+            lock_guard<mutex> lock(inboxMutex);
+            stopping = true;
+        }
+        inboxReady.notify_one();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    long getMovesApplied() const { return movesApplied; }
+    long getMovesRejected() const { return movesRejected; }
+};
+
+// Hosts many concurrent games, sharded by game ID (the low 32 bits % shardCount pick the shard).
+// Requests for one game always land on the same shard queue, so they stay in order.
+class GameServer {
+private:
+    MoveReplyHandler onReply;
+    vector<unique_ptr<GameShard>> shards;
+    atomic<uint32_t> nextShard{0};
+
+    GameShard& shardFor(GameId gameId) {
+        return *shards[gameSlotIndex(gameId) % shards.size()];
+    }
+
+    void post(GameRequest::Kind kind, GameId gameId, int startX = 0, int startY = 0, int endX = 0, int endY = 0,
+              PieceType promotion = PieceType::QUEEN) {
+        shardFor(gameId).post({kind, static_cast<uint8_t>(startX), static_cast<uint8_t>(startY),
+                               static_cast<uint8_t>(endX), static_cast<uint8_t>(endY), promotion, gameId});
+    }
+
+public:
+    explicit GameServer(uint32_t shardCount, MoveReplyHandler onReply = nullptr) : onReply(move(onReply)) {
+        for (uint32_t i = 0; i < shardCount; ++i) {
+            shards.push_back(make_unique<GameShard>(shardCount, this->onReply));
+        }
+    }
+
+    GameId createGame() {
+        uint32_t shardIndex = nextShard++ % shards.size();
+        auto [slot, generation] = shards[shardIndex]->allocateSlot();
+        GameId gameId = static_cast<GameId>(generation) << 32 | (slot * static_cast<uint32_t>(shards.size()) + shardIndex);
+        post(GameRequest::Kind::CREATE, gameId);
+        return gameId;
+    }
+
+    void submitMove(GameId gameId, int startX, int startY, int endX, int endY, PieceType promotion = PieceType::QUEEN) {
+        if (startX < 0 || startX >= 8 || startY < 0 || startY >= 8 || endX < 0 || endX >= 8 || endY < 0 || endY >= 8) {
+            throw out_of_range("Index out of bounds");
+        }
+        post(GameRequest::Kind::MOVE, gameId, startX, startY, endX, endY, promotion);
+    }
+
+    void closeGame(GameId gameId) {
+        post(GameRequest::Kind::CLOSE, gameId);
+    }
+
+    void flush() {
+        for (auto& shard : shards) {
+            shard->flush();
+        }
+    }
+
+    void shutdown() {
+        for (auto& shard : shards) {
+            shard->stop();
+        }
+    }
+
+    long getMovesApplied() const {
+        long total = 0;
+        for (const auto& shard : shards) total += shard->getMovesApplied();
+        return total;
+    }
+
+    long getMovesRejected() const {
+        long total = 0;
+        for (const auto& shard : shards) total += shard->getMovesRejected();
+        return total;
+    }
+};
+
+// Many clients driving many games: each client thread shuffles knights in its own games
+void runServerBenchmark(int gameCount, int roundsPerGame, int clientThreads) {
+    uint32_t shardCount = max(1u, thread::hardware_concurrency());
+    GameServer server(shardCount);
+
+    vector<GameId> gameIds(gameCount);
+    for (int i = 0; i < gameCount; ++i) {
+        gameIds[i] = server.createGame();
+    }
+
+    auto startTime = chrono::steady_clock::now();
+    vector<thread> clients;
+    for (int c = 0; c < clientThreads; ++c) {
+        clients.emplace_back([&, c] {
+            for (int round = 0; round < roundsPerGame; ++round) {
+                for (int i = c; i < gameCount; i += clientThreads) {
+                    server.submitMove(gameIds[i], 0, 6, 2, 5); // Ng1-f3
+                    server.submitMove(gameIds[i], 7, 6, 5, 5); // Ng8-f6
+                    server.submitMove(gameIds[i], 2, 5, 0, 6); // Nf3-g1
+                    server.submitMove(gameIds[i], 5, 5, 7, 6); // Nf6-g8
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    server.shutdown();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    long moves = server.getMovesApplied();
+    cout << "\nServer: " << gameCount << " games on " << shardCount << " shards (" << sizeof(Game)
+         << " bytes per game), " << moves << " moves applied, " << server.getMovesRejected() << " rejected, "
+         << static_cast<long>(moves / seconds) << " moves/sec" << endl;
+}
+
 int main() {
-    Game& chessGame = Game::getInstance();
+    Game chessGame;
     Board& board = chessGame.getBoard();
 
     // Simple game loop simulation
@@ -324,5 +1905,98 @@ int main() {
     // Example: White makes a valid move for knight (0, 1) to (2, 2)
     chessGame.makeMove(0, 1, 2, 2);
 
+    // Evaluation is read off the incrementally maintained state
+    Evaluator evaluator;
+    cout << "\nEvaluation (Black to move): " << evaluator.evaluate(board, Color::BLACK) << endl;
+
+    // A search tries a move and takes it back; the score must return to where it was
+    int before = board.getPsqtScore();
+    MoveRecord trial = board.makeMove(6, 3, 5, 3);
+    cout << "PST score after trial move: " << board.getPsqtScore() << endl;
+    board.unmakeMove(trial);
+    cout << "PST score restored: " << (board.getPsqtScore() == before ? "yes" : "no") << endl;
+
+    // FEN round trip
+    cout << "\nFEN: " << chessGame.toFen() << endl;
+    chessGame.loadFen("7k/P7/8/8/8/8/8/K7 w - - 0 1");
+    chessGame.makeMove(6, 0, 7, 0, PieceType::KING); // a8=K is not a legal promotion
+    chessGame.loadFen("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    chessGame.makeMove(0, 4, 0, 6); // White castles kingside
+    cout << "FEN after O-O: " << chessGame.toFen() << endl;
+
+    // Batch replay: write a small PGN file and stream it back through the validator
+    const string pgnPath = "/tmp/chess_replay.pgn";
+    {
+        ofstream out(pgnPath);
+        for (int i = 0; i < 2000; ++i) {
+            out << "[Event \"Opera Game\"]\n[Result \"1-0\"]\n\n"
+                << "1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7\n"
+                << "8. Nc3 c6 9. Bg5 b5 10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7\n"
+                << "14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+ Nxb8 17. Rd8# 1-0\n\n"
+                << "[Event \"Special moves\"]\n[Result \"*\"]\n\n"
+                << "1. e4 Nf6 2. e5 d5 3. exd6 {en passant} c6 4. dxe7 Qb6 5. exf8=Q+ Kxf8 *\n\n";
+        }
+    }
+    PgnReplayer replayer(chessGame);
+    ReplayStats stats = replayer.replayFile(pgnPath);
+    cout << "\nReplayed " << stats.games << " games (" << stats.failedGames << " rejected, "
+         << stats.moves << " moves) at " << static_cast<long>(stats.gamesPerSecond()) << " games/sec" << endl;
+
+    runServerBenchmark(100000, 2, 4);
+
+    // Moves for closed or never-created games are rejected, not played on a recycled board
+    {
+        GameServer server(1, [](const GameRequest& request, MoveStatus status) {
+            cout << "Game " << gameSlotIndex(request.gameId) << " (generation " << gameGeneration(request.gameId) << "): "
+                 << (status == MoveStatus::NO_GAME ? "no such game" : status == MoveStatus::OK ? "moved" : "rejected") << endl;
+        });
+        GameId gameId = server.createGame();
+        server.closeGame(gameId);
+        server.submitMove(gameId, 1, 4, 3, 4);
+        server.flush();
+        GameId reused = server.createGame(); // same slot, next generation
+        server.submitMove(gameId, 1, 4, 3, 4); // the old id must not reach the new game
+        server.submitMove(reused, 1, 4, 3, 4);
+        server.submitMove(12345, 1, 4, 3, 4);
+        server.shutdown();
+    }
+
+    // Engine: answers from the opening book or tablebase before falling back to search
+    const char* sourceNames[] = { "none", "book", "tablebase", "search", "checkmate", "stalemate" };
+    auto describe = [&](const EngineMove& m) -> string {
+        if (m.startX < 0) return sourceNames[static_cast<int>(m.source)];
+        return squareName(m.startX, m.startY) + squareName(m.endX, m.endY) + " ("
+            + sourceNames[static_cast<int>(m.source)] + ")";
+    };
+
+    // Offline: build a tiny book from the first moves of the Opera Game
+    vector<OpeningBook::Entry> bookEntries;
+    Game bookGame;
+    const int line[][4] = { {1, 4, 3, 4}, {6, 4, 4, 4}, {0, 6, 2, 5}, {6, 3, 5, 3} }; // 1. e4 e5 2. Nf3 d6
+    for (const auto& m : line) {
+        bookEntries.push_back({bookGame.getZobristKey(), encodeBookMove(m[0], m[1], m[2], m[3]), 100});
+        bookGame.tryMove(m[0], m[1], m[2], m[3]);
+    }
+    OpeningBook::write("/tmp/chess_book.bin", bookEntries);
+
+    // Offline: one tablebase record, KQ vs K with mate in one (Qg7#)
+    Game endgame;
+    endgame.loadFen("7k/8/6QK/8/8/8/8/8 w - - 0 1");
+    EndgameTablebase::write("/tmp/chess_tablebase.bin", {{endgame.getZobristKey(), 1, 0, 1, encodeBookMove(5, 6, 6, 6), 0}});
+
+    OpeningBook book("/tmp/chess_book.bin");
+    EndgameTablebase tablebase("/tmp/chess_tablebase.bin", 5);
+    Engine engine(&book, &tablebase);
+
+    Game engineGame;
+    cout << "\nEngine from the start position: " << describe(engine.chooseMove(engineGame, 3)) << endl;
+    cout << "Engine in KQ vs K: " << describe(engine.chooseMove(endgame, 3)) << endl;
+    engineGame.loadFen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    cout << "Engine out of book: " << describe(engine.chooseMove(engineGame, 3)) << endl;
+    engineGame.loadFen("7k/6Q1/7K/8/8/8/8/8 b - - 0 1");
+    cout << "Engine after Qg7#: " << describe(engine.chooseMove(engineGame, 0)) << endl;
+    engineGame.loadFen("7k/8/6QK/8/8/8/8/8 b - - 0 1");
+    cout << "Engine with no legal move and no check: " << describe(engine.chooseMove(engineGame, 2)) << endl;
+
     return 0;
 }
@@ -4,6 +4,22 @@
 #include <list>
 #include <ctime>
 #include <cstdlib>
+#include <cstdint>
+#include <climits>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <atomic>
+#include <map>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+#include <optional>
 
 using namespace std;
 
@@ -20,6 +36,12 @@ enum class RunType {
     ZERO, SINGLE, DOUBLE, TRIPLE, FOUR, SIX, WIDE, NO_BALL, WICKET
 };
 
+// Per-outcome effects, indexed by RunType (same rules as Innings::play)
+const int RUNS_FOR_OUTCOME[9]      = { 0, 1, 2, 3, 4, 6, 1, 1, 0 };
+const int IS_LEGAL_DELIVERY[9]     = { 1, 1, 1, 1, 1, 1, 0, 0, 1 };
+const int IS_WICKET[9]             = { 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+const int OUTCOME_COUNT = 9;
+
 class Player {
 public:
     string name;
@@ -53,6 +75,14 @@ public:
     }
 };
 
+// Position of a player in the team list (players are identified by index on the wire)
+inline uint8_t playerIndex(const Team& team, const Player* player) {
+    for (size_t i = 0; i < team.players.size(); ++i) {
+        if (team.players[i] == player) return static_cast<uint8_t>(i);
+    }
+    return 0xFF;
+}
+
 class Ball {
 public:
     Player* batsman;
@@ -142,9 +172,16 @@ private:
     Team* bowlingTeam;
     list<IObserver*> observers;
     int totalOvers;
+    Player* batsman;
+    Player* nonStriker;
+    Player* bowler;
 
 public:
-    Innings(Team* bat, Team* bowl, int overs) : battingTeam(bat), bowlingTeam(bowl), totalOvers(overs) {}
+    Innings(Team* bat, Team* bowl, int overs)
+        : battingTeam(bat), bowlingTeam(bowl), totalOvers(overs),
+          batsman(bat->players[bat->wicketsFallen]),
+          nonStriker(bat->players[bat->wicketsFallen + 1]),
+          bowler(bowl->players[bowl->players.size() - 1]) {}
 
     void registerObserver(IObserver* observer) {
         observers.push_back(observer);
@@ -159,62 +196,81 @@ public:
             observer->update(ball, *battingTeam);
         }
     }
+
+    bool isAllOut() const {
+        return battingTeam->wicketsFallen >= static_cast<int>(battingTeam->players.size()) - 1;
+    }
+
+    bool isComplete() const {
+        return isAllOut() || battingTeam->legalDeliveriesBowled >= totalOvers * 6;
+    }
+
+    // Applies one delivery (from the simulator or a live scorer) and notifies observers.
+    // Returns true when the delivery completed an over.
+    bool recordBall(RunType run) {
+        Ball ball(batsman, bowler, run);
+        bool isLegalDelivery = true;
+
+        // Individual figures: extras go to the team, not the batsman; wides are not faced
+        int outcome = static_cast<int>(run);
+        if (run != RunType::WIDE && run != RunType::NO_BALL) {
+            batsman->runsScored += RUNS_FOR_OUTCOME[outcome];
+        }
+        batsman->ballsFaced += (run != RunType::WIDE);
+        bowler->ballsBowled += IS_LEGAL_DELIVERY[outcome];
+        bowler->wicketsTaken += IS_WICKET[outcome];
+
+        switch (run) {
+            case RunType::WICKET:
+                battingTeam->wicketsFallen++;
+                if (battingTeam->wicketsFallen + 1 < static_cast<int>(battingTeam->players.size())) {
+                    batsman = battingTeam->players[battingTeam->wicketsFallen + 1];
+                }
+                break;
+            case RunType::SINGLE:
+                battingTeam->totalRuns += 1;
+                swap(batsman, nonStriker);
+                break;
+            case RunType::TRIPLE:
+                 battingTeam->totalRuns += 3;
+                 swap(batsman, nonStriker);
+                 break;
+            case RunType::WIDE:
+            case RunType::NO_BALL:
+                battingTeam->totalRuns += 1;
+                isLegalDelivery = false; // Does not count as a legal ball
+                break;
+            case RunType::ZERO: break;
+            case RunType::DOUBLE: battingTeam->totalRuns += 2; break;
+            case RunType::FOUR: battingTeam->totalRuns += 4; break;
+            case RunType::SIX: battingTeam->totalRuns += 6; break;
+        }
+
+        if (isLegalDelivery) {
+            battingTeam->legalDeliveriesBowled++;
+        }
+
+        notifyObservers(ball);
+
+        if (isLegalDelivery && battingTeam->legalDeliveriesBowled % 6 == 0) {
+            swap(batsman, nonStriker); // Swap strike at end of over
+            return true;
+        }
+        return false;
+    }
     
     // CORRECTED: Simulation logic is now clearer.
     void play() {
         cout << "\n--- Starting Innings for " << battingTeam->name << " ---" << endl;
-        
-        Player* batsman = battingTeam->players[battingTeam->wicketsFallen];
-        Player* nonStriker = battingTeam->players[battingTeam->wicketsFallen + 1];
-        Player* bowler = bowlingTeam->players[bowlingTeam->players.size() - 1]; 
-
-        int totalBalls = totalOvers * 6;
-        while (battingTeam->legalDeliveriesBowled < totalBalls) {
-            if (battingTeam->wicketsFallen >= battingTeam->players.size() - 1) {
-                cout << "All out!" << endl;
-                break;
-            }
 
+        while (!isComplete()) {
             int randomOutcome = rand() % 9;
-            RunType run = static_cast<RunType>(randomOutcome);
-            
-            Ball ball(batsman, bowler, run);
-            bool isLegalDelivery = true;
-
-            switch (run) {
-                case RunType::WICKET:
-                    battingTeam->wicketsFallen++;
-                    batsman = battingTeam->players[battingTeam->wicketsFallen + 1];
-                    break;
-                case RunType::SINGLE:
-                    battingTeam->totalRuns += 1;
-                    swap(batsman, nonStriker);
-                    break;
-                case RunType::TRIPLE:
-                     battingTeam->totalRuns += 3;
-                     swap(batsman, nonStriker);
-                     break;
-                case RunType::WIDE:
-                case RunType::NO_BALL:
-                    battingTeam->totalRuns += 1;
-                    isLegalDelivery = false; // Does not count as a legal ball
-                    break;
-                case RunType::ZERO: break;
-                case RunType::DOUBLE: battingTeam->totalRuns += 2; break;
-                case RunType::FOUR: battingTeam->totalRuns += 4; break;
-                case RunType::SIX: battingTeam->totalRuns += 6; break;
-            }
-            
-            if (isLegalDelivery) {
-                battingTeam->legalDeliveriesBowled++;
-            }
-            
-            notifyObservers(ball);
-
-            if (isLegalDelivery && battingTeam->legalDeliveriesBowled % 6 == 0) {
+            if (recordBall(static_cast<RunType>(randomOutcome))) {
                 cout << "--- End of Over " << battingTeam->legalDeliveriesBowled / 6 << " ---" << endl;
-                swap(batsman, nonStriker); // Swap strike at end of over
             }
+        }
+        if (isAllOut()) {
+            cout << "All out!" << endl;
         }
          cout << "\n--- End of Innings for " << battingTeam->name << ". Final Score: "
              << battingTeam->totalRuns << "/" << battingTeam->wicketsFallen << " ---" << endl;
@@ -229,6 +285,22 @@ private:
     list<IObserver*> observers;
     Team* winner;
 
+    // Event-driven scoring state (see recordBall)
+    unique_ptr<Innings> currentInnings;
+    int completedInnings = 0;
+
+    unique_ptr<Innings> newInnings(Team* bat, Team* bowl) {
+        unique_ptr<Innings> innings = make_unique<Innings>(bat, bowl, format->getTotalOvers());
+        for (auto obs : observers) innings->registerObserver(obs);
+        return innings;
+    }
+
+    void decideWinner() {
+        if (teamA->totalRuns > teamB->totalRuns) winner = teamA;
+        else if (teamB->totalRuns > teamA->totalRuns) winner = teamB;
+        else winner = nullptr; // Draw
+    }
+
 public:
     Match(Team* a, Team* b, IMatchFormatStrategy* f) : teamA(a), teamB(b), format(f), winner(nullptr) {}
 
@@ -236,6 +308,35 @@ public:
         observers.push_back(observer);
     }
 
+    // Event-driven alternative to start(): a scorer feeds deliveries one at a time and
+    // innings advance automatically. Returns false once the match is over.
+    bool recordBall(RunType run) {
+        if (isOver()) {
+            return false;
+        }
+        if (!currentInnings) {
+            currentInnings = newInnings(teamA, teamB);
+        }
+        currentInnings->recordBall(run);
+        if (currentInnings->isComplete()) {
+            if (++completedInnings == 1) {
+                currentInnings = newInnings(teamB, teamA);
+            } else {
+                currentInnings.reset();
+                decideWinner();
+            }
+        }
+        return true;
+    }
+
+    bool isOver() const {
+        return completedInnings >= 2;
+    }
+
+    Team* getWinner() const {
+        return winner;
+    }
+
     void start() {
         cout << "Starting a " << (format->getTotalOvers() == 20 ? "T20" : "ODI") 
              << " match between " << teamA->name << " and " << teamB->name << endl;
@@ -249,11 +350,10 @@ public:
         Innings secondInnings(teamB, teamA, format->getTotalOvers());
         for (auto obs : observers) secondInnings.registerObserver(obs);
         secondInnings.play();
+        completedInnings = 2;
         
         // Determine Winner
-        if (teamA->totalRuns > teamB->totalRuns) winner = teamA;
-        else if (teamB->totalRuns > teamA->totalRuns) winner = teamB;
-        else winner = nullptr; // Draw
+        decideWinner();
 
         cout << "\n================= MATCH ENDED =================" << endl;
         if (winner) {
@@ -272,7 +372,1250 @@ public:
 };
 
 //------------------------------------------------------------------------------------
-// 5. MAIN DRIVER
+// 5. BATCH MONTE CARLO SIMULATION: headless, for win-probability estimates
+//------------------------------------------------------------------------------------
+
+// xoshiro256** PRNG: small, fast, and one instance per thread so nothing is shared
+class Xoshiro256 {
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    explicit Xoshiro256(uint64_t seed) {
+        for (uint64_t& word : s) {
+            // splitmix64 to spread the seed over the state
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, bound) from the top 32 bits (multiply-shift, no division)
+    uint32_t nextBelow(uint32_t bound) {
+        return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+    }
+};
+
+struct SimulationResult {
+    long matches = 0;
+    long teamAWins = 0;
+    long teamBWins = 0;
+    long ties = 0;
+    double seconds = 0;
+
+    double matchesPerSecond() const { return seconds > 0 ? matches / seconds : 0; }
+};
+
+// Simulates matches with the same ball outcomes as Innings::play, without observers
+// or output. Matches are laid out struct-of-arrays and advanced a ball at a time in
+// lockstep, so the inner loop is a flat, branch-free pass over plain int arrays.
+class BatchMatchSimulator {
+private:
+    static const int LANES = 256; // matches advanced together by one thread
+
+    int totalBalls;
+    int maxWickets;
+
+    // One innings for every lane; a lane stops once its runs pass its target
+    void playInnings(int* runs, const int* target, Xoshiro256& rng) const {
+        int wickets[LANES] = {};
+        int legalBalls[LANES] = {};
+        int outcome[LANES];
+        bool anyActive = true;
+        while (anyActive) {
+            for (int i = 0; i < LANES; ++i) {
+                outcome[i] = static_cast<int>(rng.nextBelow(OUTCOME_COUNT));
+            }
+            int active = 0;
+            for (int i = 0; i < LANES; ++i) {
+                int live = (legalBalls[i] < totalBalls) & (wickets[i] < maxWickets) & (runs[i] <= target[i]);
+                runs[i] += live * RUNS_FOR_OUTCOME[outcome[i]];
+                wickets[i] += live * IS_WICKET[outcome[i]];
+                legalBalls[i] += live * IS_LEGAL_DELIVERY[outcome[i]];
+                active |= live;
+            }
+            anyActive = active != 0;
+        }
+    }
+
+public:
+    BatchMatchSimulator(const IMatchFormatStrategy& format)
+        : totalBalls(format.getTotalOvers() * 6), maxWickets(format.getMaxPlayers() - 1) {}
+
+    SimulationResult run(long matches, unsigned threads, uint64_t seed = 42) const {
+        threads = max(1u, threads);
+        vector<SimulationResult> perThread(threads);
+        auto startTime = chrono::steady_clock::now();
+
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                Xoshiro256 rng(seed + t);
+                SimulationResult& result = perThread[t];
+                long totalBatches = (matches + LANES - 1) / LANES;
+                long batches = totalBatches / threads + (t < totalBatches % threads ? 1 : 0);
+                int noTarget[LANES];
+                fill(noTarget, noTarget + LANES, INT_MAX);
+                for (long b = 0; b < batches; ++b) {
+                    int runsA[LANES] = {};
+                    int runsB[LANES] = {};
+                    playInnings(runsA, noTarget, rng);
+                    playInnings(runsB, runsA, rng);
+                    for (int i = 0; i < LANES; ++i) {
+                        result.teamAWins += runsA[i] > runsB[i];
+                        result.teamBWins += runsB[i] > runsA[i];
+                        result.ties += runsA[i] == runsB[i];
+                    }
+                    result.matches += LANES;
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        SimulationResult total;
+        for (const SimulationResult& r : perThread) {
+            total.matches += r.matches;
+            total.teamAWins += r.teamAWins;
+            total.teamBWins += r.teamBWins;
+            total.ties += r.ties;
+        }
+        total.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        return total;
+    }
+};
+
+//------------------------------------------------------------------------------------
+// 6. LIVE WIN PROBABILITY: precomputed chase table + observer
+//------------------------------------------------------------------------------------
+
+// P(chasing side wins | balls remaining, wickets in hand, runs required).
+// For each (balls, wickets) state the builder simulates many chase remainders and
+// keeps the distribution of runs they score; P(remaining runs >= r) then fills in
+// every runs-required column at once.
+class WinProbabilityTable {
+private:
+    int totalBalls;
+    int maxWickets;
+    int maxRuns;
+    vector<float> probabilities; // [balls][wickets][runs]
+
+    size_t index(int balls, int wickets, int runs) const {
+        return (static_cast<size_t>(balls) * (maxWickets + 1) + wickets) * (maxRuns + 1) + runs;
+    }
+
+    WinProbabilityTable(int totalBalls, int maxWickets, int maxRuns)
+        : totalBalls(totalBalls), maxWickets(maxWickets), maxRuns(maxRuns),
+          probabilities(static_cast<size_t>(totalBalls + 1) * (maxWickets + 1) * (maxRuns + 1), 0.0f) {}
+
+public:
+    // Offline: runs in parallel, one (balls, wickets) state at a time per thread
+    static WinProbabilityTable build(const IMatchFormatStrategy& format, int samplesPerState, unsigned threads, uint64_t seed = 7) {
+        int totalBalls = format.getTotalOvers() * 6;
+        int maxWickets = format.getMaxPlayers() - 1;
+        WinProbabilityTable table(totalBalls, maxWickets, 6 * totalBalls);
+        threads = max(1u, threads);
+        int stateCount = (totalBalls + 1) * (maxWickets + 1);
+
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                Xoshiro256 rng(seed + t);
+                vector<int> countWithRuns(table.maxRuns + 2);
+                for (int state = t; state < stateCount; state += threads) {
+                    int balls = state / (maxWickets + 1);
+                    int wickets = state % (maxWickets + 1);
+                    fill(countWithRuns.begin(), countWithRuns.end(), 0);
+                    for (int sample = 0; sample < samplesPerState; ++sample) {
+                        int runs = 0, legal = 0, lost = 0;
+                        while (legal < balls && lost < wickets) {
+                            int outcome = static_cast<int>(rng.nextBelow(OUTCOME_COUNT));
+                            runs += RUNS_FOR_OUTCOME[outcome];
+                            lost += IS_WICKET[outcome];
+                            legal += IS_LEGAL_DELIVERY[outcome];
+                        }
+                        ++countWithRuns[min(runs, table.maxRuns + 1)];
+                    }
+                    // Survival function: samples that scored at least r
+                    int atLeast = 0;
+                    for (int r = table.maxRuns + 1; r >= 0; --r) {
+                        atLeast += countWithRuns[r];
+                        if (r <= table.maxRuns) {
+                            table.probabilities[table.index(balls, wickets, r)] = static_cast<float>(atLeast) / samplesPerState;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return table;
+    }
+
+    // O(1) lookup; states outside the table are already decided
+    float chaseWinProbability(int ballsRemaining, int wicketsInHand, int runsRequired) const {
+        if (runsRequired <= 0) return 1.0f;
+        if (runsRequired > maxRuns || ballsRemaining <= 0 || wicketsInHand <= 0) return 0.0f;
+        return probabilities[index(min(ballsRemaining, totalBalls), min(wicketsInHand, maxWickets), runsRequired)];
+    }
+
+    void save(const string& path) const {
+        ofstream out(path, ios::binary);
+        int header[3] = { totalBalls, maxWickets, maxRuns };
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(probabilities.data()), probabilities.size() * sizeof(float));
+    }
+
+    static WinProbabilityTable load(const string& path) {
+        ifstream in(path, ios::binary);
+        int header[3];
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+            throw runtime_error("Cannot read win probability table: " + path);
+        }
+        // Check the dimensions before sizing anything from them: a damaged header must not
+        // turn into a huge allocation. Up to 100 overs a side, 6 runs a ball.
+        int balls = header[0], wickets = header[1], runs = header[2];
+        if (balls < 1 || balls > 600 || wickets < 1 || wickets > 20 || runs < 0 || runs > 6 * balls) {
+            throw runtime_error("Corrupt win probability table header: " + path);
+        }
+        size_t cells = static_cast<size_t>(balls + 1) * (wickets + 1) * (runs + 1);
+        in.seekg(0, ios::end);
+        if (static_cast<uint64_t>(in.tellg()) != sizeof(header) + cells * sizeof(float)) {
+            throw runtime_error("Win probability table size does not match its header: " + path);
+        }
+        in.seekg(sizeof(header));
+        WinProbabilityTable table(balls, wickets, runs);
+        if (!in.read(reinterpret_cast<char*>(table.probabilities.data()), table.probabilities.size() * sizeof(float))) {
+            throw runtime_error("Truncated win probability table: " + path);
+        }
+        return table;
+    }
+};
+
+// Concrete Observer 3: live win-probability meter for the chasing side.
+// Each ball is a single table lookup; nothing is simulated during the match.
+class WinProbabilityMeter : public IObserver {
+private:
+    const WinProbabilityTable& table;
+    const Team& battingFirst;
+    int totalBalls;
+    int maxWickets;
+    float chaseWinProbability = -1.0f; // negative until the chase starts
+
+public:
+    WinProbabilityMeter(const WinProbabilityTable& table, const Team& battingFirst, const IMatchFormatStrategy& format)
+        : table(table), battingFirst(battingFirst), totalBalls(format.getTotalOvers() * 6),
+          maxWickets(format.getMaxPlayers() - 1) {}
+
+    void update(const Ball&, const Team& battingTeam) override {
+        if (&battingTeam == &battingFirst) {
+            return; // the table models the chase only
+        }
+        int runsRequired = battingFirst.totalRuns + 1 - battingTeam.totalRuns;
+        chaseWinProbability = table.chaseWinProbability(totalBalls - battingTeam.legalDeliveriesBowled,
+                                                        maxWickets - battingTeam.wicketsFallen, runsRequired);
+        cout << "WIN PROBABILITY: " << battingTeam.name << " " << static_cast<int>(chaseWinProbability * 100 + 0.5f)
+             << "% | " << battingFirst.name << " " << static_cast<int>((1 - chaseWinProbability) * 100 + 0.5f) << "%" << endl;
+    }
+
+    float getChaseWinProbability() const {
+        return chaseWinProbability;
+    }
+};
+
+//------------------------------------------------------------------------------------
+// 7. LIVE SCORE BROADCAST: delta events over a lock-free ring, fanned out to many subscribers
+//------------------------------------------------------------------------------------
+
+// One ball as a delta against the previous state. Runs, wickets and legal balls all
+// follow from the outcome, so the whole event packs into a single 64-bit word.
+struct ScoreDelta {
+    uint32_t sequence;
+    uint8_t innings;      // 0 or 1
+    uint8_t outcome;      // RunType
+    uint8_t batsmanIndex;
+    uint8_t bowlerIndex;
+
+    uint64_t pack() const {
+        return static_cast<uint64_t>(sequence) | static_cast<uint64_t>(innings) << 32 | static_cast<uint64_t>(outcome) << 40
+             | static_cast<uint64_t>(batsmanIndex) << 48 | static_cast<uint64_t>(bowlerIndex) << 56;
+    }
+
+    static ScoreDelta unpack(uint64_t word) {
+        return { static_cast<uint32_t>(word), static_cast<uint8_t>(word >> 32), static_cast<uint8_t>(word >> 40),
+                 static_cast<uint8_t>(word >> 48), static_cast<uint8_t>(word >> 56) };
+    }
+};
+
+// Absolute match state as a subscriber sees it
+struct LiveScore {
+    uint32_t deltasApplied = 0;
+    uint16_t runs[2] = {};
+    uint8_t wickets[2] = {};
+    uint16_t legalBalls[2] = {};
+
+    void apply(const ScoreDelta& delta) {
+        runs[delta.innings] += RUNS_FOR_OUTCOME[delta.outcome];
+        wickets[delta.innings] += IS_WICKET[delta.outcome];
+        legalBalls[delta.innings] += IS_LEGAL_DELIVERY[delta.outcome];
+        deltasApplied = delta.sequence + 1;
+    }
+};
+
+// Single-producer, many-consumer broadcast ring. The producer overwrites slots without
+// ever waiting for readers; every slot is one atomic word carrying its own sequence, so
+// a reader can tell a fresh slot from one that has been lapped. Alongside the ring the
+// latest absolute state is published under a seqlock for readers that fall behind.
+class ScoreBroadcastRing {
+private:
+    vector<atomic<uint64_t>> slots;
+    uint64_t mask;
+    atomic<uint64_t> head{0}; // number of deltas published
+
+    atomic<uint32_t> snapshotVersion{0}; // odd while the producer is writing
+    atomic<uint64_t> snapshotWords[2];
+
+public:
+    explicit ScoreBroadcastRing(size_t capacityPowerOfTwo) : slots(capacityPowerOfTwo), mask(capacityPowerOfTwo - 1) {
+        for (auto& slot : slots) slot.store(~0ULL, memory_order_relaxed);
+        snapshotWords[0].store(0, memory_order_relaxed);
+        snapshotWords[1].store(0, memory_order_relaxed);
+    }
+
+    size_t capacity() const { return slots.size(); }
+    uint64_t published() const { return head.load(memory_order_acquire); }
+
+    // Producer side: wait-free
+    void publish(const ScoreDelta& delta, const LiveScore& state) {
+        slots[delta.sequence & mask].store(delta.pack(), memory_order_release);
+        head.store(static_cast<uint64_t>(delta.sequence) + 1, memory_order_release);
+
+        snapshotVersion.fetch_add(1, memory_order_acq_rel);
+        snapshotWords[0].store(static_cast<uint64_t>(state.deltasApplied) | static_cast<uint64_t>(state.runs[0]) << 32
+                               | static_cast<uint64_t>(state.runs[1]) << 48, memory_order_relaxed);
+        snapshotWords[1].store(static_cast<uint64_t>(state.wickets[0]) | static_cast<uint64_t>(state.wickets[1]) << 8
+                               | static_cast<uint64_t>(state.legalBalls[0]) << 16 | static_cast<uint64_t>(state.legalBalls[1]) << 32,
+                               memory_order_relaxed);
+        snapshotVersion.fetch_add(1, memory_order_release);
+    }
+
+    // Consumer side: false if the slot does not (or no longer) hold this sequence
+    bool read(uint64_t sequence, ScoreDelta& delta) const {
+        delta = ScoreDelta::unpack(slots[sequence & mask].load(memory_order_acquire));
+        return delta.sequence == static_cast<uint32_t>(sequence);
+    }
+
+    LiveScore latest() const {
+        LiveScore state;
+        uint32_t before, after;
+        uint64_t w0, w1;
+        do {
+            before = snapshotVersion.load(memory_order_acquire);
+            w0 = snapshotWords[0].load(memory_order_relaxed);
+            w1 = snapshotWords[1].load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            after = snapshotVersion.load(memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        state.deltasApplied = static_cast<uint32_t>(w0);
+        state.runs[0] = static_cast<uint16_t>(w0 >> 32);
+        state.runs[1] = static_cast<uint16_t>(w0 >> 48);
+        state.wickets[0] = static_cast<uint8_t>(w1);
+        state.wickets[1] = static_cast<uint8_t>(w1 >> 8);
+        state.legalBalls[0] = static_cast<uint16_t>(w1 >> 16);
+        state.legalBalls[1] = static_cast<uint16_t>(w1 >> 32);
+        return state;
+    }
+};
+
+// Concrete Observer 4: turns each Ball into a delta and publishes it. Never blocks,
+// so Innings::play runs at full speed however many subscribers there are.
+class ScoreBroadcaster : public IObserver {
+private:
+    ScoreBroadcastRing& ring;
+    const Team& battingFirst;
+    const Team& battingSecond;
+    LiveScore state;
+
+public:
+    ScoreBroadcaster(ScoreBroadcastRing& ring, const Team& battingFirst, const Team& battingSecond)
+        : ring(ring), battingFirst(battingFirst), battingSecond(battingSecond) {}
+
+    void update(const Ball& ball, const Team& battingTeam) override {
+        uint8_t innings = (&battingTeam == &battingFirst) ? 0 : 1;
+        const Team& bowlingTeam = innings == 0 ? battingSecond : battingFirst;
+        ScoreDelta delta = { state.deltasApplied, innings, static_cast<uint8_t>(ball.run),
+                             playerIndex(battingTeam, ball.batsman), playerIndex(bowlingTeam, ball.bowler) };
+        state.apply(delta);
+        ring.publish(delta, state);
+    }
+};
+
+// A subscriber's view: its own cursor into the shared ring plus the state it has built
+struct ScoreSubscriber {
+    uint64_t cursor = 0;
+    LiveScore view;
+    long deltasReceived = 0;
+    long resyncs = 0; // times it fell behind and was coalesced to the latest state
+};
+
+// Serves a group of subscribers from one thread. A subscriber that falls more than a
+// ring's worth behind skips the backlog and jumps straight to the latest snapshot.
+class FanoutWorker {
+private:
+    const ScoreBroadcastRing& ring;
+    vector<ScoreSubscriber> subscribers;
+
+public:
+    FanoutWorker(const ScoreBroadcastRing& ring, size_t subscriberCount) : ring(ring), subscribers(subscriberCount) {}
+
+    // Delivers at most maxDeltas to one subscriber (a slow consumer takes fewer per turn)
+    void poll(ScoreSubscriber& sub, uint64_t head, long maxDeltas) {
+        if (head - sub.cursor > ring.capacity()) {
+            sub.view = ring.latest();
+            sub.cursor = sub.view.deltasApplied;
+            ++sub.resyncs;
+        }
+        ScoreDelta delta;
+        for (long n = 0; sub.cursor < head && n < maxDeltas; ++n) {
+            if (!ring.read(sub.cursor, delta)) {
+                sub.view = ring.latest(); // lapped mid-read
+                sub.cursor = sub.view.deltasApplied;
+                ++sub.resyncs;
+                continue;
+            }
+            sub.view.apply(delta);
+            ++sub.cursor;
+            ++sub.deltasReceived;
+        }
+    }
+
+    // Runs until stop is set and every subscriber has caught up
+    void run(const atomic<bool>& stop, size_t slowEvery) {
+        while (true) {
+            bool finished = stop.load(memory_order_acquire);
+            uint64_t head = ring.published();
+            for (size_t i = 0; i < subscribers.size(); ++i) {
+                bool slow = slowEvery != 0 && i % slowEvery == 0 && !finished;
+                poll(subscribers[i], head, slow ? 1 : LONG_MAX);
+            }
+            if (finished) {
+                return;
+            }
+            this_thread::yield();
+        }
+    }
+
+    const vector<ScoreSubscriber>& getSubscribers() const {
+        return subscribers;
+    }
+};
+
+//------------------------------------------------------------------------------------
+// 8. SCORECARD: per-player figures maintained incrementally, read via a seqlock
+//------------------------------------------------------------------------------------
+
+const int MAX_SQUAD = 11;
+const int MAX_OVERS = 50;
+
+struct BattingFigures {
+    int runs = 0, balls = 0, fours = 0, sixes = 0;
+    bool out = false;
+    double strikeRate() const { return balls ? 100.0 * runs / balls : 0.0; }
+};
+
+struct BowlingFigures {
+    int legalBalls = 0, runsConceded = 0, wickets = 0;
+    double economy() const { return legalBalls ? 6.0 * runsConceded / legalBalls : 0.0; }
+};
+
+struct FallOfWicket {
+    int wicketNumber, teamRuns, legalBalls, batsmanIndex;
+};
+
+// Everything on one side's card, in fixed-size arrays so the whole card is a flat,
+// trivially copyable block that readers can snapshot in one pass
+struct InningsCard {
+    int totalRuns = 0, wickets = 0, legalBalls = 0, extras = 0;
+    BattingFigures batting[MAX_SQUAD];
+    BowlingFigures bowling[MAX_SQUAD];
+    int partnershipRuns = 0, partnershipBalls = 0;
+    FallOfWicket fallOfWickets[MAX_SQUAD];
+    int runsInOver[MAX_OVERS] = {}; // completed and current overs
+    double runRate() const { return legalBalls ? 6.0 * totalRuns / legalBalls : 0.0; }
+
+    bool sameFiguresAs(const InningsCard& other) const {
+        if (totalRuns != other.totalRuns || wickets != other.wickets || legalBalls != other.legalBalls || extras != other.extras) {
+            return false;
+        }
+        for (int i = 0; i < MAX_SQUAD; ++i) {
+            if (batting[i].runs != other.batting[i].runs || batting[i].balls != other.batting[i].balls
+                || bowling[i].runsConceded != other.bowling[i].runsConceded || bowling[i].wickets != other.bowling[i].wickets) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // One ball, O(1); batsman and bowler are indices into their team lists
+    void apply(RunType run, int batsman, int bowler) {
+        int outcome = static_cast<int>(run);
+        int runs = RUNS_FOR_OUTCOME[outcome];
+        bool isExtra = run == RunType::WIDE || run == RunType::NO_BALL;
+
+        totalRuns += runs;
+        legalBalls += IS_LEGAL_DELIVERY[outcome];
+        extras += isExtra ? runs : 0;
+        partnershipRuns += runs;
+        partnershipBalls += IS_LEGAL_DELIVERY[outcome];
+        runsInOver[min((legalBalls - IS_LEGAL_DELIVERY[outcome]) / 6, MAX_OVERS - 1)] += runs;
+
+        if (batsman < MAX_SQUAD) {
+            BattingFigures& bat = batting[batsman];
+            bat.runs += isExtra ? 0 : runs;
+            bat.balls += run != RunType::WIDE;
+            bat.fours += run == RunType::FOUR;
+            bat.sixes += run == RunType::SIX;
+        }
+        if (bowler < MAX_SQUAD) {
+            BowlingFigures& bowl = bowling[bowler];
+            bowl.legalBalls += IS_LEGAL_DELIVERY[outcome];
+            bowl.runsConceded += runs;
+            bowl.wickets += IS_WICKET[outcome];
+        }
+        if (run == RunType::WICKET && wickets < MAX_SQUAD) {
+            if (batsman < MAX_SQUAD) batting[batsman].out = true;
+            fallOfWickets[wickets] = { wickets + 1, totalRuns, legalBalls, batsman };
+            ++wickets;
+            partnershipRuns = 0;
+            partnershipBalls = 0;
+        }
+    }
+};
+
+struct ScorecardSnapshot {
+    InningsCard innings[2];
+};
+
+// Concrete Observer 5: full scorecard. Each Ball touches a constant number of fields.
+// The writer updates a private card, then copies just the touched words into an array
+// of atomics, bracketed by a sequence counter (odd = writing). Readers copy the atomics
+// and retry if the counter moved, so any number of readers get a consistent snapshot
+// without ever blocking Innings::play, and no plain memory is read while being written.
+class ScorecardObserver : public IObserver {
+private:
+    struct alignas(uint64_t) PaddedCard {
+        ScorecardSnapshot card;
+    };
+    static const size_t WORDS = sizeof(PaddedCard) / sizeof(uint64_t);
+
+    const Team& battingFirst;
+    const Team& battingSecond;
+    PaddedCard working; // touched only by the writer
+    atomic<uint64_t> published[WORDS];
+    atomic<uint32_t> version{0};
+
+    // Copies the words covering [field, field + bytes) of the working card to the readers' copy
+    void publish(const void* field, size_t bytes) {
+        const char* base = reinterpret_cast<const char*>(&working);
+        size_t offset = static_cast<const char*>(field) - base;
+        for (size_t w = offset / sizeof(uint64_t); w * sizeof(uint64_t) < offset + bytes; ++w) {
+            uint64_t word;
+            memcpy(&word, base + w * sizeof(uint64_t), sizeof(word));
+            published[w].store(word, memory_order_relaxed);
+        }
+    }
+
+public:
+    ScorecardObserver(const Team& battingFirst, const Team& battingSecond)
+        : battingFirst(battingFirst), battingSecond(battingSecond) {
+        publish(&working, sizeof(working));
+    }
+
+    void update(const Ball& ball, const Team& battingTeam) override {
+        int side = (&battingTeam == &battingFirst) ? 0 : 1;
+        const Team& bowlingTeam = side == 0 ? battingSecond : battingFirst;
+        int batsman = playerIndex(battingTeam, ball.batsman);
+        int bowler = playerIndex(bowlingTeam, ball.bowler);
+
+        InningsCard& c = working.card.innings[side];
+        int over = min(c.legalBalls / 6, MAX_OVERS - 1);
+        int wicketsBefore = c.wickets;
+        c.apply(ball.run, batsman, bowler);
+
+        uint32_t v = version.load(memory_order_relaxed);
+        version.store(v + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+
+        publish(&c.totalRuns, reinterpret_cast<const char*>(&c.batting) - reinterpret_cast<const char*>(&c.totalRuns));
+        publish(&c.partnershipRuns, 2 * sizeof(int));
+        publish(&c.runsInOver[over], sizeof(int));
+        if (batsman < MAX_SQUAD) publish(&c.batting[batsman], sizeof(BattingFigures));
+        if (bowler < MAX_SQUAD) publish(&c.bowling[bowler], sizeof(BowlingFigures));
+        if (c.wickets != wicketsBefore) publish(&c.fallOfWickets[wicketsBefore], sizeof(FallOfWicket));
+
+        version.store(v + 2, memory_order_release);
+    }
+
+    // Safe from any thread
+    ScorecardSnapshot snapshot() const {
+        PaddedCard copy;
+        uint64_t words[WORDS];
+        uint32_t before, after;
+        do {
+            before = version.load(memory_order_acquire);
+            for (size_t w = 0; w < WORDS; ++w) {
+                words[w] = published[w].load(memory_order_relaxed);
+            }
+            atomic_thread_fence(memory_order_acquire);
+            after = version.load(memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        memcpy(&copy, words, sizeof(copy));
+        return copy.card;
+    }
+
+    void print(const ScorecardSnapshot& snap) const {
+        const Team* teams[2] = { &battingFirst, &battingSecond };
+        for (int side = 0; side < 2; ++side) {
+            const InningsCard& c = snap.innings[side];
+            const Team& bat = *teams[side];
+            const Team& bowl = *teams[1 - side];
+            cout << "\n=========== " << bat.name << " " << c.totalRuns << "/" << c.wickets << " ("
+                 << c.legalBalls / 6 << "." << c.legalBalls % 6 << " ov, RR " << c.runRate() << ") ===========" << endl;
+            for (size_t i = 0; i < bat.players.size() && i < MAX_SQUAD; ++i) {
+                const BattingFigures& b = c.batting[i];
+                if (b.balls == 0 && !b.out) continue;
+                cout << "  " << bat.players[i]->name << (b.out ? " (out) " : " (not out) ") << b.runs << " (" << b.balls
+                     << ") 4s:" << b.fours << " 6s:" << b.sixes << " SR:" << b.strikeRate() << endl;
+            }
+            cout << "  Extras: " << c.extras << endl;
+            for (size_t i = 0; i < bowl.players.size() && i < MAX_SQUAD; ++i) {
+                const BowlingFigures& b = c.bowling[i];
+                if (b.legalBalls == 0) continue;
+                cout << "  " << bowl.players[i]->name << " " << b.legalBalls / 6 << "." << b.legalBalls % 6 << "-"
+                     << b.runsConceded << "-" << b.wickets << " Econ:" << b.economy() << endl;
+            }
+            cout << "  Fall of wickets:";
+            for (int w = 0; w < c.wickets; ++w) {
+                cout << " " << c.fallOfWickets[w].teamRuns << "-" << c.fallOfWickets[w].wicketNumber;
+            }
+            cout << "\n  Current partnership: " << c.partnershipRuns << " (" << c.partnershipBalls << ")" << endl;
+            cout << "  Runs per over:";
+            for (int o = 0; o * 6 < c.legalBalls && o < MAX_OVERS; ++o) {
+                cout << " " << c.runsInOver[o];
+            }
+            cout << endl;
+        }
+    }
+};
+
+//------------------------------------------------------------------------------------
+// 9. BALL-BY-BALL EVENT LOG: compact binary format and fast replay
+//------------------------------------------------------------------------------------
+
+// Log layout (one match per file):
+//   "CBLG" | version u8 | overs u8 | for each team: name, player count u8, player names
+//   then one little-endian u16 per ball:
+//   bit 0 innings | bits 1-4 outcome (RunType) | bits 5-8 batsman id | bits 9-12 bowler id
+// Names are u8 length + bytes. Player ids are indices into the team lists in the header,
+// so a logged squad holds at most 16 players.
+const char LOG_MAGIC[4] = { 'C', 'B', 'L', 'G' };
+const uint8_t LOG_VERSION = 1;
+const size_t MAX_LOG_SQUAD = 16;
+
+inline uint16_t encodeBall(int innings, RunType run, int batsman, int bowler) {
+    if (batsman < 0 || batsman >= static_cast<int>(MAX_LOG_SQUAD) || bowler < 0 || bowler >= static_cast<int>(MAX_LOG_SQUAD)) {
+        throw out_of_range("Player id does not fit the ball log");
+    }
+    return static_cast<uint16_t>((innings & 1) | (static_cast<int>(run) & 0xF) << 1 | (batsman & 0xF) << 5 | (bowler & 0xF) << 9);
+}
+
+// Concrete Observer 6: appends every Ball to the log, buffered in memory
+class BallLogWriter : public IObserver {
+private:
+    string path;
+    ofstream out;
+    const Team& battingFirst;
+    const Team& battingSecond;
+    vector<uint8_t> buffer;
+    long ballsLogged = 0;
+
+    static void writeName(vector<uint8_t>& bytes, const string& name) {
+        size_t length = min<size_t>(name.size(), 255);
+        bytes.push_back(static_cast<uint8_t>(length));
+        bytes.insert(bytes.end(), name.begin(), name.begin() + length);
+    }
+
+public:
+    BallLogWriter(const string& path, const Team& battingFirst, const Team& battingSecond, const IMatchFormatStrategy& format)
+        : path(path), battingFirst(battingFirst), battingSecond(battingSecond) {
+        for (const Team* team : { &battingFirst, &battingSecond }) {
+            if (team->players.size() > MAX_LOG_SQUAD) {
+                throw invalid_argument("Squad too large for the ball log: " + team->name);
+            }
+        }
+        out.open(path, ios::binary);
+        if (!out) {
+            throw runtime_error("Cannot open ball log: " + path);
+        }
+        buffer.reserve(4096 + 2);
+        for (char c : LOG_MAGIC) buffer.push_back(static_cast<uint8_t>(c));
+        buffer.push_back(LOG_VERSION);
+        buffer.push_back(static_cast<uint8_t>(format.getTotalOvers()));
+        for (const Team* team : { &battingFirst, &battingSecond }) {
+            writeName(buffer, team->name);
+            buffer.push_back(static_cast<uint8_t>(team->players.size()));
+            for (const Player* player : team->players) {
+                writeName(buffer, player->name);
+            }
+        }
+    }
+
+    // Call flush() before destruction to see write errors; the destructor cannot report them
+    ~BallLogWriter() {
+        try {
+            flush();
+        } catch (const runtime_error&) {
+        }
+    }
+
+    void update(const Ball& ball, const Team& battingTeam) override {
+        int innings = (&battingTeam == &battingFirst) ? 0 : 1;
+        const Team& bowlingTeam = innings == 0 ? battingSecond : battingFirst;
+        append(encodeBall(innings, ball.run, playerIndex(battingTeam, ball.batsman), playerIndex(bowlingTeam, ball.bowler)));
+    }
+
+    void append(uint16_t record) {
+        buffer.push_back(static_cast<uint8_t>(record));
+        buffer.push_back(static_cast<uint8_t>(record >> 8));
+        ++ballsLogged;
+        if (buffer.size() >= 4096) {
+            flush();
+        }
+    }
+
+    void flush() {
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        out.flush();
+        if (!out) {
+            throw runtime_error("Cannot write ball log: " + path);
+        }
+        buffer.clear();
+    }
+
+    long getBallsLogged() const {
+        return ballsLogged;
+    }
+};
+
+// A match log read back into memory; replays straight off the packed records
+class MatchLog {
+private:
+    vector<uint8_t> bytes;
+    size_t ballsOffset = 0;
+    int overs = 0;
+    string teamNames[2];
+    vector<string> playerNames[2];
+
+    string readName(size_t& pos) const {
+        if (pos >= bytes.size() || pos + 1 + bytes[pos] > bytes.size()) {
+            throw runtime_error("Truncated ball log header");
+        }
+        string name(reinterpret_cast<const char*>(&bytes[pos + 1]), bytes[pos]);
+        pos += 1 + bytes[pos];
+        return name;
+    }
+
+public:
+    explicit MatchLog(const string& path) {
+        ifstream in(path, ios::binary | ios::ate);
+        if (!in) {
+            throw runtime_error("Cannot open ball log: " + path);
+        }
+        bytes.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+
+        if (bytes.size() < 6 || memcmp(bytes.data(), LOG_MAGIC, 4) != 0 || bytes[4] != LOG_VERSION) {
+            throw runtime_error("Not a ball log: " + path);
+        }
+        overs = bytes[5];
+        size_t pos = 6;
+        for (int t = 0; t < 2; ++t) {
+            teamNames[t] = readName(pos);
+            if (pos >= bytes.size()) throw runtime_error("Truncated ball log header");
+            int count = bytes[pos++];
+            for (int i = 0; i < count; ++i) {
+                playerNames[t].push_back(readName(pos));
+            }
+        }
+        ballsOffset = pos;
+    }
+
+    size_t ballCount() const { return (bytes.size() - ballsOffset) / 2; }
+    int getOvers() const { return overs; }
+    const string& getTeamName(int side) const { return teamNames[side]; }
+    const vector<string>& getPlayerNames(int side) const { return playerNames[side]; }
+
+    uint16_t record(size_t ball) const {
+        return static_cast<uint16_t>(bytes[ballsOffset + 2 * ball] | bytes[ballsOffset + 2 * ball + 1] << 8);
+    }
+
+    // Match state after the first `balls` deliveries (all of them by default)
+    ScorecardSnapshot replay(size_t balls = SIZE_MAX) const {
+        ScorecardSnapshot state;
+        size_t n = min(balls, ballCount());
+        const uint8_t* p = bytes.data() + ballsOffset;
+        for (size_t i = 0; i < n; ++i, p += 2) {
+            uint16_t r = static_cast<uint16_t>(p[0] | p[1] << 8);
+            int innings = r & 1;
+            // Bowling figures are indexed by the bowling side's player ids
+            state.innings[innings].apply(static_cast<RunType>((r >> 1) & 0xF), (r >> 5) & 0xF, (r >> 9) & 0xF);
+        }
+        return state;
+    }
+};
+
+// Career figures aggregated across many match logs
+struct CareerStats {
+    long runs = 0, ballsFaced = 0, fours = 0, sixes = 0, dismissals = 0;
+    long ballsBowled = 0, runsConceded = 0, wickets = 0;
+    int matches = 0;
+};
+
+// Season-wide statistics: logs are split across threads, replayed independently and
+// the per-thread totals merged at the end (players are matched by name across logs)
+class SeasonStats {
+public:
+    static map<string, CareerStats> compute(const vector<string>& logPaths, unsigned threads) {
+        threads = max(1u, threads);
+        vector<map<string, CareerStats>> partial(threads);
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (size_t f = t; f < logPaths.size(); f += threads) {
+                    MatchLog log(logPaths[f]);
+                    ScorecardSnapshot card = log.replay();
+                    for (int side = 0; side < 2; ++side) {
+                        const InningsCard& c = card.innings[side];
+                        const vector<string>& batters = log.getPlayerNames(side);
+                        const vector<string>& bowlers = log.getPlayerNames(1 - side);
+                        for (size_t i = 0; i < batters.size() && i < MAX_SQUAD; ++i) {
+                            CareerStats& s = partial[t][batters[i]];
+                            s.runs += c.batting[i].runs;
+                            s.ballsFaced += c.batting[i].balls;
+                            s.fours += c.batting[i].fours;
+                            s.sixes += c.batting[i].sixes;
+                            s.dismissals += c.batting[i].out;
+                            ++s.matches;
+                        }
+                        for (size_t i = 0; i < bowlers.size() && i < MAX_SQUAD; ++i) {
+                            CareerStats& s = partial[t][bowlers[i]];
+                            s.ballsBowled += c.bowling[i].legalBalls;
+                            s.runsConceded += c.bowling[i].runsConceded;
+                            s.wickets += c.bowling[i].wickets;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        map<string, CareerStats> total;
+        for (const auto& part : partial) {
+            for (const auto& [name, s] : part) {
+                CareerStats& sum = total[name];
+                sum.runs += s.runs;
+                sum.ballsFaced += s.ballsFaced;
+                sum.fours += s.fours;
+                sum.sixes += s.sixes;
+                sum.dismissals += s.dismissals;
+                sum.ballsBowled += s.ballsBowled;
+                sum.runsConceded += s.runsConceded;
+                sum.wickets += s.wickets;
+                sum.matches += s.matches;
+            }
+        }
+        return total;
+    }
+};
+
+//------------------------------------------------------------------------------------
+// 10. MULTI-MATCH SCORING SERVICE: per-match mailboxes drained by a thread pool
+//------------------------------------------------------------------------------------
+
+// A scorer's report of one delivery in one hosted match
+struct BallEvent {
+    uint32_t matchId;
+    RunType run;
+};
+
+// Hosts many matches at once. Each match has its own mailbox; a match with pending
+// events is put on the ready queue exactly once (the `scheduled` flag), so at most one
+// pool thread works on a match at a time and match state needs no locks.
+class ScoringService {
+private:
+    struct HostedMatch {
+        unique_ptr<Team> teamA;
+        unique_ptr<Team> teamB;
+        unique_ptr<Match> match;
+        mutex mailboxMutex;
+        vector<RunType> mailbox;
+        atomic<bool> scheduled{false};
+        long ballsApplied = 0; // written only by the thread holding `scheduled`
+    };
+
+    vector<unique_ptr<HostedMatch>> matches;
+    mutex readyMutex;
+    condition_variable readyCondition;
+    deque<uint32_t> readyQueue;
+    bool stopping = false;
+    vector<thread> pool;
+    atomic<long> eventsRejected{0};
+
+    void schedule(uint32_t matchId) {
+        {
+            lock_guard<mutex> lock(readyMutex);
+            readyQueue.push_back(matchId);
+        }
+        readyCondition.notify_one();
+    }
+
+    void drain(uint32_t matchId) {
+        HostedMatch& hosted = *matches[matchId];
+        vector<RunType> batch;
+        {
+            lock_guard<mutex> lock(hosted.mailboxMutex);
+            batch.swap(hosted.mailbox);
+        }
+        for (RunType run : batch) {
+            if (hosted.match->recordBall(run)) ++hosted.ballsApplied;
+            else ++eventsRejected; // match already over
+        }
+
+        // Hand the match back; pick it up again if events arrived meanwhile
+        hosted.scheduled.store(false, memory_order_release);
+        bool pending;
+        {
+            lock_guard<mutex> lock(hosted.mailboxMutex);
+            pending = !hosted.mailbox.empty();
+        }
+        if (pending && !hosted.scheduled.exchange(true, memory_order_acq_rel)) {
+            schedule(matchId);
+        }
+    }
+
+    void workerLoop() {
+        while (true) {
+            uint32_t matchId;
+            {
+                unique_lock<mutex> lock(readyMutex);
+                readyCondition.wait(lock, [this] { return stopping || !readyQueue.empty(); });
+                if (readyQueue.empty()) {
+                    return;
+                }
+                matchId = readyQueue.front();
+                readyQueue.pop_front();
+            }
+            drain(matchId);
+        }
+    }
+
+public:
+    explicit ScoringService(unsigned threads) {
+        for (unsigned i = 0; i < max(1u, threads); ++i) {
+            pool.emplace_back(&ScoringService::workerLoop, this);
+        }
+    }
+
+    ~ScoringService() {
+        shutdown();
+    }
+
+    // Not thread-safe with submit(); register matches before scorers start
+    uint32_t hostMatch(const string& nameA, const vector<string>& playersA,
+                       const string& nameB, const vector<string>& playersB, IMatchFormatStrategy* format) {
+        unique_ptr<HostedMatch> hosted = make_unique<HostedMatch>();
+        hosted->teamA = make_unique<Team>(nameA, playersA);
+        hosted->teamB = make_unique<Team>(nameB, playersB);
+        hosted->match = make_unique<Match>(hosted->teamA.get(), hosted->teamB.get(), format);
+        matches.push_back(move(hosted));
+        return static_cast<uint32_t>(matches.size() - 1);
+    }
+
+    // Observers run on pool threads; register before scoring starts
+    void registerObserver(uint32_t matchId, IObserver* observer) {
+        if (matchId >= matches.size()) throw out_of_range("Unknown match");
+        matches[matchId]->match->registerObserver(observer);
+    }
+
+    // Called by scorers from any thread; never waits on match processing
+    void submit(const BallEvent& event) {
+        if (event.matchId >= matches.size()) throw out_of_range("Unknown match");
+        HostedMatch& hosted = *matches[event.matchId];
+        {
+            lock_guard<mutex> lock(hosted.mailboxMutex);
+            hosted.mailbox.push_back(event.run);
+        }
+        if (!hosted.scheduled.exchange(true, memory_order_acq_rel)) {
+            schedule(event.matchId);
+        }
+    }
+
+    // Processes everything already submitted, then stops the pool
+    void shutdown() {
+        {
+            lock_guard<mutex> lock(readyMutex);
+            stopping = true;
+        }
+        readyCondition.notify_all();
+        for (auto& worker : pool) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    // Read after shutdown()
+    size_t matchCount() const { return matches.size(); }
+    const Match& getMatch(uint32_t matchId) const { return *matches[matchId]->match; }
+    long getBallsApplied(uint32_t matchId) const { return matches[matchId]->ballsApplied; }
+    long getEventsRejected() const { return eventsRejected; }
+};
+
+// Hosts `matchCount` T20 matches fed concurrently by `scorers` threads
+void runScoringServiceBenchmark(int matchCount, unsigned scorers) {
+    ScoringService service(thread::hardware_concurrency());
+    vector<string> squad;
+    for (int i = 1; i <= 11; ++i) squad.push_back("P" + to_string(i));
+    for (int m = 0; m < matchCount; ++m) {
+        service.hostMatch("Home" + to_string(m), squad, "Away" + to_string(m), squad, new T20Format());
+    }
+    try {
+        service.submit({static_cast<uint32_t>(matchCount), RunType::SINGLE});
+    } catch (const out_of_range& e) {
+        cout << "Scoring service rejected an event: " << e.what() << endl;
+    }
+
+    // Enough deliveries to finish any T20 match; surplus events are rejected
+    const int eventsPerMatch = 600;
+    auto startTime = chrono::steady_clock::now();
+    vector<thread> scorerThreads;
+    for (unsigned t = 0; t < scorers; ++t) {
+        scorerThreads.emplace_back([&, t] {
+            Xoshiro256 rng(1000 + t);
+            for (int e = 0; e < eventsPerMatch; ++e) {
+                for (int m = t; m < matchCount; m += scorers) {
+                    service.submit({static_cast<uint32_t>(m), static_cast<RunType>(rng.nextBelow(OUTCOME_COUNT))});
+                }
+            }
+        });
+    }
+    for (auto& t : scorerThreads) t.join();
+    service.shutdown();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    long balls = 0, finished = 0;
+    for (uint32_t m = 0; m < service.matchCount(); ++m) {
+        balls += service.getBallsApplied(m);
+        finished += service.getMatch(m).isOver();
+    }
+    cout << "Scoring service: " << matchCount << " concurrent matches, " << finished << " completed, "
+         << balls << " balls scored (" << service.getEventsRejected() << " surplus rejected), "
+         << static_cast<long>(balls / seconds) << " balls/sec" << endl;
+}
+
+//------------------------------------------------------------------------------------
+// 11. HISTORICAL STATS QUERY ENGINE: columnar ball store with bitmap indexes
+//------------------------------------------------------------------------------------
+
+enum class BowlingStyle : uint8_t {
+    RIGHT_ARM_PACE, LEFT_ARM_PACE, RIGHT_ARM_SPIN, LEFT_ARM_SPIN, UNKNOWN
+};
+const int BOWLING_STYLE_COUNT = 5;
+
+// Filters for one query; -1 leaves a dimension unconstrained. Overs are 0-based.
+struct BallQuery {
+    int batsman = -1;
+    int bowler = -1;
+    int bowlingStyle = -1;
+    int firstOver = 0;
+    int lastOver = 255;
+};
+
+struct QueryResult {
+    long ballsFaced = 0, runs = 0, dismissals = 0, dotBalls = 0, fours = 0, sixes = 0;
+    double milliseconds = 0;
+    double strikeRate() const { return ballsFaced ? 100.0 * runs / ballsFaced : 0.0; }
+};
+
+// One row per delivery, one array per column. Low-cardinality columns (bowling style,
+// over, outcome) also get a bitmap per value; player columns are filtered by scanning
+// 64 rows at a time into a bitmap word. Queries AND bitmaps word by word and aggregate
+// with popcounts over the outcome bitmaps, so no row is materialised.
+class BallEventStore {
+private:
+    vector<uint16_t> batsmanColumn;
+    vector<uint16_t> bowlerColumn;
+    vector<uint8_t> styleColumn;
+    vector<uint8_t> overColumn;
+    vector<uint8_t> outcomeColumn;
+
+    vector<vector<uint64_t>> styleBitmaps;   // [style][word]
+    vector<vector<uint64_t>> overBitmaps;    // [over][word]
+    vector<vector<uint64_t>> outcomeBitmaps; // [outcome][word]
+
+    vector<string> playerNames;
+    unordered_map<string, uint16_t> playerIds;
+
+    static void setBit(vector<vector<uint64_t>>& bitmaps, size_t value, size_t row) {
+        if (bitmaps.size() <= value) bitmaps.resize(value + 1);
+        vector<uint64_t>& bitmap = bitmaps[value];
+        if (bitmap.size() <= row / 64) bitmap.resize(row / 64 + 1, 0);
+        bitmap[row / 64] |= 1ULL << (row % 64);
+    }
+
+    static long popcount64(uint64_t word) {
+        return __builtin_popcountll(word);
+    }
+
+    static uint64_t wordOf(const vector<vector<uint64_t>>& bitmaps, size_t value, size_t word) {
+        return value < bitmaps.size() && word < bitmaps[value].size() ? bitmaps[value][word] : 0;
+    }
+
+    // Equality scan of one 64-row block of a player column
+    static uint64_t scanEquals(const vector<uint16_t>& column, size_t word, uint16_t id) {
+        size_t begin = word * 64;
+        size_t end = min(begin + 64, column.size());
+        uint64_t mask = 0;
+        for (size_t row = begin; row < end; ++row) {
+            mask |= static_cast<uint64_t>(column[row] == id) << (row - begin);
+        }
+        return mask;
+    }
+
+    void appendRow(uint16_t batsman, uint16_t bowler, BowlingStyle style, int over, RunType run) {
+        size_t row = batsmanColumn.size();
+        batsmanColumn.push_back(batsman);
+        bowlerColumn.push_back(bowler);
+        styleColumn.push_back(static_cast<uint8_t>(style));
+        overColumn.push_back(static_cast<uint8_t>(over));
+        outcomeColumn.push_back(static_cast<uint8_t>(run));
+        setBit(styleBitmaps, static_cast<size_t>(style), row);
+        setBit(overBitmaps, static_cast<size_t>(over), row);
+        setBit(outcomeBitmaps, static_cast<size_t>(run), row);
+    }
+
+public:
+    uint16_t playerId(const string& name) {
+        auto it = playerIds.find(name);
+        if (it != playerIds.end()) return it->second;
+        playerNames.push_back(name);
+        return playerIds[name] = static_cast<uint16_t>(playerNames.size() - 1);
+    }
+
+    // Empty for an unknown name, so a typo can never turn into an unconstrained query
+    optional<int> findPlayer(const string& name) const {
+        auto it = playerIds.find(name);
+        if (it == playerIds.end()) return nullopt;
+        return it->second;
+    }
+
+    size_t rowCount() const { return batsmanColumn.size(); }
+
+    // Bowling styles come from a player registry; the logs only carry names
+    void appendLog(const MatchLog& log, const map<string, BowlingStyle>& styles) {
+        uint16_t ids[2][MAX_SQUAD];
+        BowlingStyle bowlerStyles[2][MAX_SQUAD];
+        for (int side = 0; side < 2; ++side) {
+            const vector<string>& names = log.getPlayerNames(side);
+            for (size_t i = 0; i < names.size() && i < MAX_SQUAD; ++i) {
+                ids[side][i] = playerId(names[i]);
+                auto style = styles.find(names[i]);
+                bowlerStyles[side][i] = style == styles.end() ? BowlingStyle::UNKNOWN : style->second;
+            }
+        }
+        int legalBalls[2] = {0, 0};
+        for (size_t ball = 0; ball < log.ballCount(); ++ball) {
+            uint16_t r = log.record(ball);
+            int innings = r & 1;
+            RunType run = static_cast<RunType>((r >> 1) & 0xF);
+            int batsman = (r >> 5) & 0xF, bowler = (r >> 9) & 0xF;
+            if (batsman >= MAX_SQUAD || bowler >= MAX_SQUAD) continue;
+            appendRow(ids[innings][batsman], ids[1 - innings][bowler], bowlerStyles[1 - innings][bowler],
+                      legalBalls[innings] / 6, run);
+            legalBalls[innings] += IS_LEGAL_DELIVERY[static_cast<int>(run)];
+        }
+    }
+
+    QueryResult run(const BallQuery& query) const {
+        int players = static_cast<int>(playerNames.size());
+        if (query.batsman < -1 || query.batsman >= players || query.bowler < -1 || query.bowler >= players) {
+            throw invalid_argument("Query names a player that is not in the store");
+        }
+        auto startTime = chrono::steady_clock::now();
+        QueryResult result;
+        size_t words = (rowCount() + 63) / 64;
+        int lastOver = min(query.lastOver, static_cast<int>(overBitmaps.size()) - 1);
+
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t selected = (w + 1 == words && rowCount() % 64) ? (1ULL << (rowCount() % 64)) - 1 : ~0ULL;
+            if (query.bowlingStyle >= 0) {
+                selected &= wordOf(styleBitmaps, query.bowlingStyle, w);
+            }
+            if (query.firstOver > 0 || query.lastOver < 255) {
+                uint64_t inOvers = 0;
+                for (int over = query.firstOver; over <= lastOver; ++over) {
+                    inOvers |= wordOf(overBitmaps, over, w);
+                }
+                selected &= inOvers;
+            }
+            if (selected && query.batsman >= 0) {
+                selected &= scanEquals(batsmanColumn, w, static_cast<uint16_t>(query.batsman));
+            }
+            if (selected && query.bowler >= 0) {
+                selected &= scanEquals(bowlerColumn, w, static_cast<uint16_t>(query.bowler));
+            }
+            if (!selected) {
+                continue;
+            }
+
+            // Aggregates straight from the outcome bitmaps
+            for (int outcome = 0; outcome < OUTCOME_COUNT; ++outcome) {
+                long count = popcount64(selected & wordOf(outcomeBitmaps, outcome, w));
+                RunType run = static_cast<RunType>(outcome);
+                bool isExtra = run == RunType::WIDE || run == RunType::NO_BALL;
+                result.ballsFaced += run != RunType::WIDE ? count : 0;
+                result.runs += isExtra ? 0 : count * RUNS_FOR_OUTCOME[outcome];
+                result.dismissals += run == RunType::WICKET ? count : 0;
+                result.dotBalls += run == RunType::ZERO ? count : 0;
+                result.fours += run == RunType::FOUR ? count : 0;
+                result.sixes += run == RunType::SIX ? count : 0;
+            }
+        }
+        result.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+        return result;
+    }
+};
+
+//------------------------------------------------------------------------------------
+// 12. MAIN DRIVER
 //------------------------------------------------------------------------------------
 
 int main() {
@@ -288,14 +1631,170 @@ int main() {
     Scoreboard* scoreboard = new Scoreboard();
     Commentary* commentary = new Commentary();
 
+    // Built offline in production and loaded at startup; built here for the demo
+    T20Format tableFormat;
+    WinProbabilityTable::build(tableFormat, 1000, thread::hardware_concurrency()).save("/tmp/t20_win_probability.bin");
+    WinProbabilityTable winTable = WinProbabilityTable::load("/tmp/t20_win_probability.bin");
+    WinProbabilityMeter* winMeter = new WinProbabilityMeter(winTable, india, tableFormat);
+
+    // Live broadcast: 4 fan-out threads x 25k subscribers, every 1000th one slow. The ring
+    // holds a whole T20 match, so a subscriber only resyncs if it falls a match behind.
+    ScoreBroadcastRing ring(1024);
+    ScoreBroadcaster* broadcaster = new ScoreBroadcaster(ring, india, australia);
+    atomic<bool> stopFanout{false};
+    vector<FanoutWorker> fanout;
+    for (int i = 0; i < 4; ++i) fanout.emplace_back(ring, 25000);
+    vector<thread> fanoutThreads;
+    for (auto& worker : fanout) {
+        fanoutThreads.emplace_back([&worker, &stopFanout] { worker.run(stopFanout, 1000); });
+    }
+
     match.registerObserver(scoreboard);
     match.registerObserver(commentary);
+    match.registerObserver(winMeter);
+    match.registerObserver(broadcaster);
+
+    // Every ball goes to the event log as well
+    BallLogWriter* ballLog = new BallLogWriter("/tmp/match_001.cblog", india, australia, *t20Format);
+    match.registerObserver(ballLog);
+
+    // Scorecard with concurrent readers checking every snapshot adds up
+    ScorecardObserver* scorecard = new ScorecardObserver(india, australia);
+    match.registerObserver(scorecard);
+    atomic<bool> matchOver{false};
+    atomic<long> snapshotsRead{0}, inconsistentSnapshots{0};
+    vector<thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&] {
+            do {
+                ScorecardSnapshot snap = scorecard->snapshot();
+                for (const InningsCard& c : snap.innings) {
+                    int batRuns = 0;
+                    for (const BattingFigures& b : c.batting) batRuns += b.runs;
+                    inconsistentSnapshots += (batRuns + c.extras != c.totalRuns);
+                }
+                ++snapshotsRead;
+            } while (!matchOver.load());
+        });
+    }
 
     match.start();
 
+    matchOver = true;
+    for (auto& t : readers) t.join();
+    scorecard->print(scorecard->snapshot());
+    cout << "Scorecard readers: " << snapshotsRead << " snapshots, " << inconsistentSnapshots << " inconsistent" << endl;
+
+    // Rebuild the match from its log and time replay throughput
+    ballLog->flush();
+    MatchLog matchLog("/tmp/match_001.cblog");
+    ScorecardSnapshot replayed = matchLog.replay();
+    ScorecardSnapshot live = scorecard->snapshot();
+    bool identical = replayed.innings[0].sameFiguresAs(live.innings[0]) && replayed.innings[1].sameFiguresAs(live.innings[1]);
+    const int replayRounds = 20000;
+    auto replayStart = chrono::steady_clock::now();
+    long replayedRuns = 0;
+    for (int i = 0; i < replayRounds; ++i) {
+        replayedRuns += matchLog.replay().innings[1].totalRuns;
+    }
+    double replaySeconds = chrono::duration<double>(chrono::steady_clock::now() - replayStart).count();
+    cout << "Ball log: " << matchLog.ballCount() << " balls in " << 2 * matchLog.ballCount() << " bytes, replay "
+         << (identical ? "matches" : "DIFFERS FROM") << " the live scorecard, "
+         << static_cast<long>(replayRounds * matchLog.ballCount() / replaySeconds) << " balls/sec" << endl;
+    (void)replayedRuns;
+
+    // A season of synthetic match logs, aggregated in parallel
+    vector<string> seasonLogs;
+    Xoshiro256 seasonRng(2024);
+    for (int m = 0; m < 200; ++m) {
+        string path = "/tmp/season_" + to_string(m) + ".cblog";
+        BallLogWriter writer(path, m % 2 ? australia : india, m % 2 ? india : australia, *t20Format);
+        for (int innings = 0; innings < 2; ++innings) {
+            int wickets = 0, legal = 0, striker = 0, nonStriker = 1;
+            while (legal < 120 && wickets < 10) {
+                RunType run = static_cast<RunType>(seasonRng.nextBelow(OUTCOME_COUNT));
+                writer.append(encodeBall(innings, run, striker, 10 - legal / 24));
+                legal += IS_LEGAL_DELIVERY[static_cast<int>(run)];
+                if (run == RunType::WICKET) striker = ++wickets + 1;
+                else if (run == RunType::SINGLE || run == RunType::TRIPLE) swap(striker, nonStriker);
+            }
+        }
+        writer.flush();
+        seasonLogs.push_back(path);
+    }
+    Team touringSquad("Touring XVII", vector<string>(17, "Reserve"));
+    try {
+        BallLogWriter oversized("/tmp/touring.cblog", touringSquad, india, *t20Format);
+    } catch (const invalid_argument& e) {
+        cout << "Ball log rejected: " << e.what() << endl;
+    }
+    map<string, CareerStats> season = SeasonStats::compute(seasonLogs, thread::hardware_concurrency());
+    auto topScorer = max_element(season.begin(), season.end(),
+        [](const auto& a, const auto& b) { return a.second.runs < b.second.runs; });
+    cout << "Season (" << seasonLogs.size() << " logs): top scorer " << topScorer->first << " with "
+         << topScorer->second.runs << " runs off " << topScorer->second.ballsFaced << " balls" << endl;
+
+    runScoringServiceBenchmark(1000, 4);
+
+    // Historical queries: the season's logs, loaded repeatedly to reach 10M deliveries
+    map<string, BowlingStyle> bowlingStyles = {
+        {"Chahal", BowlingStyle::RIGHT_ARM_SPIN}, {"Arshdeep", BowlingStyle::LEFT_ARM_PACE},
+        {"Bumrah", BowlingStyle::RIGHT_ARM_PACE}, {"Shami", BowlingStyle::RIGHT_ARM_PACE},
+        {"Axar", BowlingStyle::LEFT_ARM_SPIN}, {"Jadeja", BowlingStyle::LEFT_ARM_SPIN},
+        {"Hazlewood", BowlingStyle::RIGHT_ARM_PACE}, {"Zampa", BowlingStyle::RIGHT_ARM_SPIN},
+        {"Starc", BowlingStyle::LEFT_ARM_PACE}, {"Cummins", BowlingStyle::RIGHT_ARM_PACE},
+        {"Wade", BowlingStyle::RIGHT_ARM_SPIN}};
+    vector<unique_ptr<MatchLog>> loadedLogs;
+    for (const string& path : seasonLogs) loadedLogs.push_back(make_unique<MatchLog>(path));
+    BallEventStore store;
+    while (store.rowCount() < 10000000) {
+        for (const auto& log : loadedLogs) store.appendLog(*log, bowlingStyles);
+    }
+    cout << "Lookup of a misspelt batsman: " << (store.findPlayer("Hardick") ? "found" : "no such player") << endl;
+    BallQuery middleOversVsLeftArmPace;
+    middleOversVsLeftArmPace.batsman = store.findPlayer("Hardik").value();
+    middleOversVsLeftArmPace.bowlingStyle = static_cast<int>(BowlingStyle::LEFT_ARM_PACE);
+    middleOversVsLeftArmPace.firstOver = 6;
+    middleOversVsLeftArmPace.lastOver = 14;
+    QueryResult q = store.run(middleOversVsLeftArmPace);
+    cout << "Query over " << store.rowCount() << " balls: Hardik vs left-arm pace in middle overs: " << q.runs
+         << " runs off " << q.ballsFaced << " balls, SR " << q.strikeRate() << ", " << q.dismissals
+         << " dismissals (" << q.milliseconds << " ms)" << endl;
+
+    stopFanout.store(true, memory_order_release);
+    for (auto& t : fanoutThreads) t.join();
+    long delivered = 0, resyncs = 0, consistent = 0, subscribers = 0;
+    for (const auto& worker : fanout) {
+        for (const ScoreSubscriber& sub : worker.getSubscribers()) {
+            delivered += sub.deltasReceived;
+            resyncs += sub.resyncs;
+            consistent += sub.view.runs[0] == india.totalRuns && sub.view.runs[1] == australia.totalRuns;
+            ++subscribers;
+        }
+    }
+    cout << "\nBroadcast: " << ring.published() << " deltas to " << subscribers << " subscribers, "
+         << delivered << " delivered, " << resyncs << " coalesced resyncs, "
+         << consistent << " subscribers with the final score" << endl;
+    if (delivered == 0 || consistent != subscribers) {
+        throw runtime_error("Broadcast fan-out did not deliver the final score to every subscriber");
+    }
+
     // Clean up
     delete scoreboard;
     delete commentary;
+    delete winMeter;
+    delete broadcaster;
+    delete scorecard;
+    delete ballLog;
+
+    // Headless Monte Carlo estimate of the same fixture
+    T20Format simulationFormat;
+    BatchMatchSimulator simulator(simulationFormat);
+    SimulationResult sim = simulator.run(1000000, thread::hardware_concurrency());
+    cout << "\nSimulated " << sim.matches << " T20 matches: batting first wins "
+         << 100.0 * sim.teamAWins / sim.matches << "%, chasing wins " << 100.0 * sim.teamBWins / sim.matches
+         << "%, ties " << 100.0 * sim.ties / sim.matches << "% (" << static_cast<long>(sim.matchesPerSecond())
+         << " matches/sec)" << endl;
     
     return 0;
 }